@@ -3,14 +3,19 @@
 #include "console/position_printer.hpp"
 #include "console/uci_input.hpp"
 #include "engine/Engine.hpp"
+#include "engine/benchmark.hpp"
 #include "logging/logging.hpp"
+#include "util/string_utils.hpp"
 
+#include <algorithm>
+#include <array>
 #include <iostream>
 #include <memory>
-#include <sstream>
+#include <span>
 #include <string>
+#include <string_view>
 #include <thread>
-#include <tuple>
+#include <utility>
 #include <vector>
 
 enum class EngineInterface
@@ -19,129 +24,233 @@ enum class EngineInterface
 	UCI
 };
 
+// Commands are looked up once, on the console thread, and dispatched by ID
+enum class CommandID
+{
+	Empty,
+	Unknown,
+	Help,
+	Quit,
+	Print,
+	Bench,
+	Uci,
+	IsReady,
+	UciNewGame,
+	Position,
+	Go,
+	Stop,
+	Ponderhit,
+	SetOption
+};
+
+constexpr std::array<std::pair<std::string_view, CommandID>, 13> command_names = {{{"help", CommandID::Help},
+																				   {"?", CommandID::Help},
+																				   {"quit", CommandID::Quit},
+																				   {"print", CommandID::Print},
+																				   {"bench", CommandID::Bench},
+																				   {"uci", CommandID::Uci},
+																				   {"isready", CommandID::IsReady},
+																				   {"ucinewgame", CommandID::UciNewGame},
+																				   {"position", CommandID::Position},
+																				   {"go", CommandID::Go},
+																				   {"stop", CommandID::Stop},
+																				   {"ponderhit", CommandID::Ponderhit},
+																				   {"setoption", CommandID::SetOption}}};
+
+CommandID find_command_id(std::string_view name)
+{
+	const auto found = std::find_if(command_names.begin(), command_names.end(), [name](const auto& command_name) { return command_name.first == name; });
+
+	return (found != command_names.end()) ? found->second : CommandID::Unknown;
+}
+
 std::unique_ptr<std::jthread> console_interface_thread = nullptr;
-bool console_interface_running = true;
 
 EngineInterface selected_interface = EngineInterface::UCI;  // Assume UCI for now
 
-void parse_uci_command(const std::string& command, const std::vector<std::string>& args)
+void parse_uci_command(CommandID id, std::string_view command, std::span<const std::string_view> args)
 {
-	if (command == "isready")
-	{
-		uci_isready();
-	}
-	else if (command == "ucinewgame")
-	{
-		uci_ucinewgame();
-	}
-	else if (command == "position")
+	switch (id)
 	{
-		if (args.size() >= 1)
+		case CommandID::IsReady:
 		{
-			uci_position(args);
+			uci_isready();
+			break;
 		}
-		else
+
+		case CommandID::UciNewGame:
 		{
-			log_error("Position command without arguments");
-			std::printf("Command 'position' requires FEN string\n");
+			uci_ucinewgame();
+			break;
+		}
+
+		case CommandID::Position:
+		{
+			if (args.size() >= 1)
+			{
+				uci_position(args);
+			}
+			else
+			{
+				log_error("Position command without arguments");
+				std::printf("Command 'position' requires FEN string\n");
+			}
+			break;
+		}
+
+		case CommandID::Go:
+		{
+			uci_go(args);
+			break;
+		}
+
+		case CommandID::Stop:
+		{
+			uci_stop();
+			break;
+		}
+
+		case CommandID::Ponderhit:
+		{
+			uci_ponderhit();
+			break;
+		}
+
+		case CommandID::SetOption:
+		{
+			uci_setoption(args);
+			break;
+		}
+
+		default:
+		{
+			std::printf("Unknown command: '%.*s'\n", static_cast<int>(command.size()), command.data());
+			log_error("Unknown command: '%.*s'", static_cast<int>(command.size()), command.data());
+			break;
 		}
-	}
-	else if (command == "go")
-	{
-		uci_go(args);
-	}
-	else if (command == "setoption")
-	{
-		uci_setoption(args);
-	}
-	else
-	{
-		std::printf("Unknown command: '%s'\n", command.c_str());
-		log_error("Unknown command: '%s'", command.c_str());
 	}
 }
 
-void parse_command(const std::string& command, const std::vector<std::string>& args)
+// Runs on the engine thread. The line is split again there, so the tokens point into the copy of the line the command owns.
+void parse_command(CommandID id, std::string_view line)
 {
-	if (command == "")
-	{
-		// Just do nothing for empty input
-	}
-	else if (command == "help" || command == "?")
-	{
-		std::printf(
-			"The program intends to support the UCI standard\n"
-			"Available commands (UCI omitted):\n\n"
-			"quit\n"
-			"  Quits application\n\n");
-	}
-	else if (command == "quit")
-	{
-		console_interface_running = false;
-		engine.shutdown();
-	}
-	else if (command == "print")
-	{
-		std::string position_string = format_position_to_string(engine.get_position());
+	static std::vector<std::string_view> tokens;  // Engine thread only, keeps its capacity between commands
+	tokenize(line, tokens);
 
-		std::printf("Current position:\n%s", position_string.c_str());
-	}
-	else if (command == "uci")
-	{
-		selected_interface = EngineInterface::UCI;
-		uci_start();
-	}
-	else
+	const std::span<const std::string_view> args = std::span<const std::string_view>(tokens).subspan(tokens.empty() ? 0 : 1);
+
+	switch (id)
 	{
-		switch (selected_interface)
+		case CommandID::Empty:
+		{
+			// Just do nothing for empty input
+			break;
+		}
+
+		case CommandID::Help:
 		{
-			case EngineInterface::UCI:
+			std::printf(
+				"The program intends to support the UCI standard\n"
+				"Available commands (UCI omitted):\n\n"
+				"quit\n"
+				"  Quits application\n\n"
+				"bench see\n"
+				"  Times static exchange evaluation\n\n"
+				"bench fen\n"
+				"  Times FEN parsing\n\n");
+			break;
+		}
+
+		case CommandID::Quit:
+		{
+			engine.shutdown();
+			break;
+		}
+
+		case CommandID::Print:
+		{
+			std::string position_string = format_position_to_string(engine.get_position());
+
+			std::printf("Current position:\n%s", position_string.c_str());
+			break;
+		}
+
+		case CommandID::Bench:
+		{
+			if (args.size() == 1 && args[0] == "see")
 			{
-				parse_uci_command(command, args);
-				break;
+				benchmark_see();
 			}
-
-			default:
+			else if (args.size() == 1 && args[0] == "fen")
 			{
-				log_error("Unknown command for selected interface");
-				std::printf("Unknown command for selected interface\n");
+				benchmark_fen();
 			}
+			else
+			{
+				std::printf("Usage: 'bench see' or 'bench fen'\n");
+			}
+			break;
 		}
-	}
-}
-
-std::tuple<std::string, std::vector<std::string>> parse_input(const std::string& input_line)
-{
-	std::string command;
-	std::vector<std::string> args;
 
-	std::stringstream ss(input_line);
-	std::string token;
+		case CommandID::Uci:
+		{
+			selected_interface = EngineInterface::UCI;
+			uci_start();
+			break;
+		}
 
-	std::getline(ss, command, ' ');
+		default:
+		{
+			switch (selected_interface)
+			{
+				case EngineInterface::UCI:
+				{
+					parse_uci_command(id, tokens.front(), args);
+					break;
+				}
 
-	while (std::getline(ss, token, ' '))
-	{
-		args.push_back(token);
+				default:
+				{
+					log_error("Unknown command for selected interface");
+					std::printf("Unknown command for selected interface\n");
+				}
+			}
+		}
 	}
-
-	return {command, args};
 }
 
 void console_interface_thread_loop()
 {
 	std::printf("Thinker-zero Chess Engine by Mathias Ebbensgaard Jensen\n");
 
-	while (console_interface_running)
+	// Not tied to stdio, std::cin fills its buffer with large reads instead of going through stdio a character at a time
+	std::ios::sync_with_stdio(false);
+
+	// Kept between lines so their capacity is reused
+	std::string input_line;
+	std::vector<std::string_view> tokens;
+
+	while (true)
 	{
-		std::string input_line;
-		std::getline(std::cin, input_line);
+		// End of input is treated as quit, so the engine does not outlive the GUI
+		if (!std::getline(std::cin, input_line))
+		{
+			input_line = "quit";
+		}
 
 		log_msg("> %s", input_line.c_str());
 
-		auto [command, args] = parse_input(input_line);
+		tokenize(input_line, tokens);
+		const CommandID id = tokens.empty() ? CommandID::Empty : find_command_id(tokens.front());
+
+		// Commands run in order on the engine thread, which stays responsive while searching.
+		// The command owns a copy of the line, the buffer here is overwritten by the next one.
+		engine.post_command([id, line = input_line]() { parse_command(id, line); });
 
-		parse_command(command, args);
+		if (id == CommandID::Quit)
+		{
+			break;
+		}
 	}
 }
 
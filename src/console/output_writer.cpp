@@ -0,0 +1,23 @@
+#include "output_writer.hpp"
+
+#include "logging/logging.hpp"
+
+#include <cstdio>
+#include <mutex>
+
+std::mutex output_mutex;
+
+void write_line(std::string_view line, bool flush)
+{
+	log_msg("< %.*s", static_cast<int>(line.size()), line.data());
+
+	std::lock_guard lock(output_mutex);
+
+	std::fwrite(line.data(), 1, line.size(), stdout);
+	std::fputc('\n', stdout);
+
+	if (flush)
+	{
+		std::fflush(stdout);
+	}
+}
@@ -0,0 +1,12 @@
+#ifndef CONSOLE_OUTPUT_WRITER_HPP
+#define CONSOLE_OUTPUT_WRITER_HPP
+
+#include <string_view>
+
+// All protocol output goes through here. Each line is written whole, so lines from the search thread and the engine
+// thread never interleave. Every line the engine sends is flushed right away, as stdout is fully buffered on a pipe and
+// the GUI would otherwise see it late. The only exception is the id lines, which wait in the buffer for the uciok that
+// follows them.
+void write_line(std::string_view line, bool flush);
+
+#endif  // CONSOLE_OUTPUT_WRITER_HPP
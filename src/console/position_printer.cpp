@@ -1,5 +1,6 @@
 #include "position_printer.hpp"
 
+#include "position/PositionString.hpp"
 #include "types/conversions.hpp"
 
 #include <cstdio>
@@ -67,5 +68,9 @@ std::string format_position_to_string(const Position& position)
 
 	str += " to play\n";
 
+	str += "FEN: ";
+	write_fen(position, str);
+	str += "\n";
+
 	return str;
 }
@@ -6,9 +6,16 @@
 #include "engine/UCISetting.hpp"
 #include "logging/logging.hpp"
 #include "position/PositionString.hpp"
+#include "search/SearchLimits.hpp"
+#include "search/TranspositionTable.hpp"
 #include "util/string_utils.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
 
 void uci_start()
 {
@@ -20,64 +27,155 @@ void uci_isready()
 	uci_readyok();
 }
 
+// The position command the engine position was built from. GUIs resend the whole game before every move,
+// so usually only the moves at the end are new.
+struct PositionCommand
+{
+	std::vector<std::string> base;  // startpos, or fen and the FEN fields
+	std::vector<std::string> moves;
+};
+
+PositionCommand current_position_command;
+
 void uci_ucinewgame()
 {
 	engine.new_game();
+	current_position_command = {};
 }
 
-void uci_position(const std::vector<std::string>& args)
+void uci_position(std::span<const std::string_view> args)
 {
-	PositionString position_string(args.at(0));
+	const auto moves_keyword = std::find(args.begin(), args.end(), "moves");
+
+	// Reuses the strings of the previous command, moves fit in the small string buffer
+	static PositionCommand command;
+	command.base.assign(args.begin(), moves_keyword);
+	command.moves.clear();
+
+	if (moves_keyword != args.end())
+	{
+		command.moves.assign(moves_keyword + 1, args.end());
+	}
+
+	if (command.base.empty())
+	{
+		log_error("Position command without a position");
+		return;
+	}
+
+	// Playing only the new moves keeps the key history of the moves before them
+	const bool extends_current = !current_position_command.base.empty() && command.base == current_position_command.base &&
+								 command.moves.size() >= current_position_command.moves.size() &&
+								 std::equal(current_position_command.moves.begin(), current_position_command.moves.end(), command.moves.begin());
+
+	size_t first_new_move = current_position_command.moves.size();
 
-	Position position = position_string.get_position();
-	if (args.size() >= 2 && args.at(1) == "moves")
+	if (!extends_current)
 	{
-		for (size_t i = 2; i < args.size(); i++)
+		PositionString position_string(join_tokens(args.data(), std::to_address(moves_keyword)));
+
+		if (!position_string.is_valid())
 		{
-			Move move(args.at(i));
+			std::printf("Invalid position\n");
+			return;
+		}
+
+		engine.set_position(position_string.get_position());
+		first_new_move = 0;
+	}
+
+	for (size_t i = first_new_move; i < command.moves.size(); i++)
+	{
+		const Move move = parse_move_string(engine.get_position(), command.moves.at(i));
+
+		engine.perform_move(move);
+	}
+
+	std::swap(current_position_command, command);
+}
+
+constexpr std::array<std::string_view, 12> go_keywords = {"searchmoves", "ponder", "wtime", "btime", "winc", "binc", "movestogo", "depth", "nodes", "mate", "movetime", "infinite"};
 
-			// Decode move type (if not a promotion move that is encoded in the string)
-			// This will be needed elsewhere, so should be extracted
-			if (move.get_type() == MoveType::Quiet)
+bool is_go_keyword(std::string_view token)
+{
+	return std::find(go_keywords.begin(), go_keywords.end(), token) != go_keywords.end();
+}
+
+SearchLimits parse_search_limits(std::span<const std::string_view> args)
+{
+	SearchLimits limits;
+
+	for (size_t i = 0; i < args.size(); i++)
+	{
+		const std::string_view token = args[i];
+
+		const auto next_value = [&]() { return (i + 1 < args.size()) ? parse_number<int64_t>(args[++i]) : 0; };
+
+		if (token == "wtime")
+		{
+			limits.white_time = next_value();
+		}
+		else if (token == "btime")
+		{
+			limits.black_time = next_value();
+		}
+		else if (token == "winc")
+		{
+			limits.white_increment = next_value();
+		}
+		else if (token == "binc")
+		{
+			limits.black_increment = next_value();
+		}
+		else if (token == "movestogo")
+		{
+			limits.moves_to_go = next_value();
+		}
+		else if (token == "movetime")
+		{
+			limits.move_time = next_value();
+		}
+		else if (token == "depth")
+		{
+			limits.depth = next_value();
+		}
+		else if (token == "nodes")
+		{
+			limits.nodes = next_value();
+		}
+		else if (token == "mate")
+		{
+			limits.mate = next_value();
+		}
+		else if (token == "infinite")
+		{
+			limits.infinite = true;
+		}
+		else if (token == "ponder")
+		{
+			limits.ponder = true;
+		}
+		else if (token == "searchmoves")
+		{
+			// Moves follow until the next keyword
+			while (i + 1 < args.size() && !is_go_keyword(args[i + 1]))
 			{
-				const Square from_square = move.get_from_square();
-				const Square to_square = move.get_to_square();
-				const Piece piece = position.get_piece(from_square);
-				const Color to_color = position.get_color(to_square);
-				const uint8_t from_file = from_square.get_file();
-				const uint8_t to_file = to_square.get_file();
-				const uint8_t file_diff = (from_file > to_file) ? (from_file - to_file) : (to_file - from_file);
-
-				// Castling
-				if (piece == Piece::King && file_diff > 1)
-				{
-					if (from_file > to_file)
-					{
-						move.set_type(MoveType::QueenCastle);
-					}
-					if (from_file < to_file)
-					{
-						move.set_type(MoveType::KingCastle);
-					}
-				}
-
-				// En Passant
-				if (piece == Piece::Pawn && file_diff == 1 && to_color == Color::Empty)
-				{
-					move.set_type(MoveType::EnPassant);
-				}
+				limits.search_moves.push_back(parse_move_string(engine.get_position(), args[++i]));
 			}
-
-			position.make_move(move);
+		}
+		else
+		{
+			log_error("Unknown go argument: '%.*s'", static_cast<int>(token.size()), token.data());
+			std::printf("Unknown go argument: '%.*s'\n", static_cast<int>(token.size()), token.data());
 		}
 	}
 
-	engine.set_position(position);
+	return limits;
 }
 
-void uci_go(const std::vector<std::string>& args)
+void uci_go(std::span<const std::string_view> args)
 {
-	if (args.size() >= 1 && args.at(0) == "perft")
+	if (args.size() >= 1 && args[0] == "perft")
 	{
 		if (args.size() != 2)
 		{
@@ -85,42 +183,40 @@ void uci_go(const std::vector<std::string>& args)
 			return;
 		}
 
-		engine.perft(std::stoi(args.at(1)));
+		engine.perft(parse_number<uint8_t>(args[1]));
 	}
 	else
 	{
-		engine.go();
+		engine.go(parse_search_limits(args));
 	}
 }
 
-void uci_setoption(const std::vector<std::string>& args)
+void uci_stop()
 {
-	// This parsing is kind of ass
+	engine.stop();
+}
 
-	std::string id_string = args.at(1);
+void uci_ponderhit()
+{
+	engine.ponderhit();
+}
 
-	size_t value_string_index = 2;
+void uci_setoption(std::span<const std::string_view> args)
+{
+	// setoption name <id> [value <x>], where both the id and the value may contain spaces
+	const auto name_keyword = std::find(args.begin(), args.end(), "name");
+	const auto value_keyword = std::find(args.begin(), args.end(), "value");
 
-	for (; value_string_index < args.size() && args.at(value_string_index) != "value"; value_string_index++)
+	if (name_keyword == args.end() || name_keyword > value_keyword)
 	{
-		id_string += " " + args.at(value_string_index);
+		log_error("Setoption command without a name");
+		return;
 	}
 
-	SettingID id = engine_settings.find_id_by_name(id_string);
-
-	std::string value_string;
-
-	if (value_string_index < args.size() - 1)
-	{
-		value_string_index++;
-		value_string += args.at(value_string_index);
-		value_string_index++;
-	}
+	const std::string_view id_string = join_tokens(std::to_address(name_keyword + 1), std::to_address(value_keyword));
+	const std::string_view value_string = (value_keyword != args.end()) ? join_tokens(std::to_address(value_keyword + 1), std::to_address(args.end())) : std::string_view();
 
-	for (; value_string_index < args.size(); value_string_index++)
-	{
-		value_string += " " + args.at(value_string_index);
-	}
+	SettingID id = engine_settings.find_id_by_name(id_string);
 
 	switch (id)
 	{
@@ -139,25 +235,64 @@ void uci_setoption(const std::vector<std::string>& args)
 
 		case SettingID::MaxSearchDepth:
 		{
-			engine_settings.set_max_search_depth(std::stoi(value_string));
+			engine_settings.set_max_search_depth(parse_number<uint32_t>(value_string));
 			break;
 		}
 
 		case SettingID::LogFilepath:
 		{
-			set_log_filepath(value_string);
+			set_log_filepath(std::string(value_string));
 			break;
 		}
 
 		case SettingID::Hash:
 		{
-			// Not handling hash right now
+			engine_settings.set_hash_size(parse_number<uint32_t>(value_string));
+			transposition_table.resize(engine_settings.get_hash_size());
+			break;
+		}
+
+		case SettingID::Threads:
+		{
+			engine_settings.set_thread_count(parse_number<uint32_t>(value_string));
+			break;
+		}
+
+		case SettingID::MultiPV:
+		{
+			engine_settings.set_multi_pv(parse_number<uint32_t>(value_string));
+			break;
+		}
+
+		case SettingID::ParallelSearch:
+		{
+			if (string_compare(value_string, "LazySMP"))
+			{
+				engine_settings.set_parallel_search_type(ParallelSearchType::LazySMP);
+			}
+			else if (string_compare(value_string, "ABDADA"))
+			{
+				engine_settings.set_parallel_search_type(ParallelSearchType::ABDADA);
+			}
+			break;
+		}
+
+		case SettingID::SearchAlgorithm:
+		{
+			if (string_compare(value_string, "AlphaBeta"))
+			{
+				engine_settings.set_search_algorithm(SearchAlgorithm::AlphaBeta);
+			}
+			else if (string_compare(value_string, "MCTS"))
+			{
+				engine_settings.set_search_algorithm(SearchAlgorithm::MCTS);
+			}
 			break;
 		}
 
 		default:
 		{
-			std::printf("Unhandled setting (%s)!\n", id_string.c_str());
+			std::printf("Unhandled setting (%.*s)!\n", static_cast<int>(id_string.size()), id_string.data());
 			break;
 		}
 	}
@@ -1,8 +1,8 @@
 #ifndef CONSOLE_UCI_INPUT_HPP
 #define CONSOLE_UCI_INPUT_HPP
 
-#include <string>
-#include <vector>
+#include <span>
+#include <string_view>
 
 void uci_start();
 
@@ -10,10 +10,14 @@ void uci_isready();
 
 void uci_ucinewgame();
 
-void uci_position(const std::vector<std::string>& args);
+void uci_position(std::span<const std::string_view> args);
 
-void uci_go(const std::vector<std::string>& args);
+void uci_go(std::span<const std::string_view> args);
 
-void uci_setoption(const std::vector<std::string>& args);
+void uci_stop();
+
+void uci_ponderhit();
+
+void uci_setoption(std::span<const std::string_view> args);
 
 #endif  // CONSOLE_UCI_INPUT_HPP
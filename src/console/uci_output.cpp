@@ -1,26 +1,102 @@
 #include "uci_output.hpp"
 
+#include "console/output_writer.hpp"
 #include "engine/Settings.hpp"
+#include "search/score.hpp"
+#include "util/string_utils.hpp"
+
+#include <algorithm>
+#include <string>
+
+// Lines are built here, so sending one allocates nothing once the buffer has grown
+thread_local std::string output_line;
 
 void uci_readyok()
 {
-	std::printf("readyok\n");
+	write_line("readyok", true);
 }
 
 void uci_uciok()
 {
-	std::printf(
+	write_line(
 		"id name Thinker-zero Chess Engine\n"
-		"id author Mathias Ebbensgaard Jensen\n");
+		"id author Mathias Ebbensgaard Jensen",
+		false);
 
 	// Send supported settings
-	std::printf("%s", engine_settings.get_uci_string().c_str());
-
-	std::printf("uciok\n");
+	write_line(engine_settings.get_uci_string() + "uciok", true);
 }
 
 void uci_bestmove(const Move& move)
 {
-	std::string str = move.get_string();
-	std::printf("bestmove %s\n", str.c_str());
-}
\ No newline at end of file
+	output_line.assign("bestmove ");
+	output_line += move.get_string();
+
+	write_line(output_line, true);
+}
+
+// "cp <centipawns>" or "mate <moves>", negative moves when we are getting mated
+void append_score(std::string& line, int score)
+{
+	if (score >= mate_bound)
+	{
+		line += "mate ";
+		append_number(line, (mate_score - score + 1) / 2);
+		return;
+	}
+
+	if (score <= -mate_bound)
+	{
+		line += "mate ";
+		append_number(line, -(mate_score + score) / 2);
+		return;
+	}
+
+	line += "cp ";
+	append_number(line, score);
+}
+
+void uci_info(size_t multi_pv, unsigned int depth, unsigned int selective_depth, int score, uint64_t nodes, int64_t time, unsigned int hashfull, std::span<const Move> pv)
+{
+	const uint64_t nps = nodes * 1000 / static_cast<uint64_t>(std::max<int64_t>(time, 1));
+
+	output_line.assign("info multipv ");
+	append_number(output_line, multi_pv);
+	output_line += " depth ";
+	append_number(output_line, depth);
+	output_line += " seldepth ";
+	append_number(output_line, selective_depth);
+	output_line += " score ";
+	append_score(output_line, score);
+	output_line += " nodes ";
+	append_number(output_line, nodes);
+	output_line += " nps ";
+	append_number(output_line, nps);
+	output_line += " hashfull ";
+	append_number(output_line, hashfull);
+	output_line += " time ";
+	append_number(output_line, time);
+	output_line += " pv";
+
+	for (const Move& move : pv)
+	{
+		output_line += ' ';
+		output_line += move.get_string();
+	}
+
+	// At most once an iteration, and the GUI shows the search as it goes
+	write_line(output_line, true);
+}
+
+void uci_info_currmove(unsigned int depth, const Move& move, size_t move_number)
+{
+	output_line.assign("info depth ");
+	append_number(output_line, depth);
+	output_line += " currmove ";
+	output_line += move.get_string();
+	output_line += " currmovenumber ";
+	append_number(output_line, move_number);
+
+	// Throttled by the search, so flushing costs little and the GUI shows the move while it is searched
+	write_line(output_line, true);
+}
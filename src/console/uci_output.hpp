@@ -3,10 +3,20 @@
 
 #include "types/Move.hpp"
 
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
 void uci_readyok();
 
 void uci_uciok();
 
 void uci_bestmove(const Move& move);
 
+// Sent for every line after every completed iteration. hashfull is in permille, time in milliseconds.
+void uci_info(size_t multi_pv, unsigned int depth, unsigned int selective_depth, int score, uint64_t nodes, int64_t time, unsigned int hashfull, std::span<const Move> pv);
+
+// The root move being searched, only sent once the search has been running for a while
+void uci_info_currmove(unsigned int depth, const Move& move, size_t move_number);
+
 #endif  // CONSOLE_UCI_OUTPUT_HPP
@@ -5,36 +5,85 @@
 #include "evaluation/evaluation_type.hpp"
 #include "movegen/movegen.hpp"
 #include "position/PositionAnalysis.hpp"
-#include "search/Search.hpp"
+#include "search/ThreadPool.hpp"
+#include "search/TranspositionTable.hpp"
+#include "search/score.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <mutex>
 #include <string>
 
-Engine::Engine() : m_rng(m_random_device())
+Engine::Engine() : m_rng(m_random_device()), m_thread_pool(EVALUATION_TYPE::SIMPLIFIED_EVALUATION_FUNCTION)
 {
 }
 
 void Engine::main_loop()
 {
-	while (m_engine_running)
+	while (true)
 	{
-		;
+		std::function<void()> command;
+
+		{
+			std::unique_lock lock(m_command_mutex);
+			m_command_condition.wait(lock, [this]() { return !m_engine_running || !m_commands.empty(); });
+
+			if (!m_engine_running)
+			{
+				break;
+			}
+
+			command = std::move(m_commands.front());
+			m_commands.pop_front();
+		}
+
+		command();
 	}
 }
 
+void Engine::post_command(std::function<void()> command)
+{
+	{
+		std::lock_guard lock(m_command_mutex);
+		m_commands.push_back(std::move(command));
+	}
+
+	m_command_condition.notify_one();
+}
+
 void Engine::shutdown()
 {
-	m_engine_running = false;
+	stop();
+	wait_for_search();
+
+	{
+		std::lock_guard lock(m_command_mutex);
+		m_engine_running = false;
+	}
+
+	m_command_condition.notify_one();
 }
 
 void Engine::new_game()
 {
+	stop();
+	wait_for_search();
+
+	m_thread_pool.clear();
+	transposition_table.clear();
 }
 
-void Engine::go()
+void Engine::go(SearchLimits limits)
 {
+	wait_for_search();
+
 	MoveList legal_moves = generate_legal_moves(m_position);
 
+	if (!limits.search_moves.empty())
+	{
+		std::erase_if(legal_moves, [&](const Move& move) { return std::find(limits.search_moves.begin(), limits.search_moves.end(), move) == limits.search_moves.end(); });
+	}
+
 	if (legal_moves.size() == 0)
 	{
 		uci_bestmove(Move("0000"));
@@ -48,21 +97,68 @@ void Engine::go()
 	}
 	else
 	{
-		Search search(EVALUATION_TYPE::SIMPLIFIED_EVALUATION_FUNCTION);
-		const std::vector<unsigned int> indices_for_move = search.search_for_best_move(m_position, legal_moves, engine_settings.get_max_search_depth());
+		m_thread_pool.set_thread_count(engine_settings.get_thread_count());
+		m_thread_pool.set_parallel_search_type(engine_settings.get_parallel_search_type());
+		m_thread_pool.set_search_algorithm(engine_settings.get_search_algorithm());
+		m_thread_pool.set_multi_pv(engine_settings.get_multi_pv());
+		// A bare go searches to the configured depth, any other limit lets the search go as deep as it can
+		if (limits.depth == 0)
+		{
+			const bool open_ended = limits.has_time_limit() || limits.infinite || limits.ponder || limits.nodes != 0 || limits.mate != 0;
+			limits.depth = open_ended ? max_search_ply : engine_settings.get_max_search_depth();
+		}
+
+		m_thread_pool.clear_stop();
+		m_thread_pool.start_clock(limits, m_position.get_player());
 
-		if (indices_for_move.empty() == true)
 		{
-			// No moves to be done.
-			uci_bestmove(Move("0000"));
+			std::lock_guard lock(m_search_mutex);
+			m_pondering = limits.ponder;
+			m_infinite = limits.infinite;
 		}
-		std::uniform_int_distribution<uint8_t> uid(0, indices_for_move.size() - 1);
-		const unsigned int index_for_move = uid(m_rng);
-		const Move move = legal_moves.at(indices_for_move[index_for_move]);
-		uci_bestmove(move);
+
+		m_search_thread = std::jthread(
+			[this, position = m_position, key_history = m_key_history, legal_moves = std::move(legal_moves), limits]()
+			{
+				const Move move = m_thread_pool.search_for_best_move(position, key_history, legal_moves, limits);
+
+				// The GUI does not expect a best move while we are pondering or searching infinitely
+				{
+					std::unique_lock lock(m_search_mutex);
+					m_search_condition.wait(lock, [this]() { return !m_pondering && !m_infinite; });
+				}
+
+				uci_bestmove(move);
+			});
 	}
 }
 
+void Engine::stop()
+{
+	m_thread_pool.stop();
+
+	{
+		std::lock_guard lock(m_search_mutex);
+		m_pondering = false;
+		m_infinite = false;
+	}
+
+	m_search_condition.notify_one();
+}
+
+void Engine::ponderhit()
+{
+	// From here on the clock applies
+	m_thread_pool.ponderhit();
+
+	{
+		std::lock_guard lock(m_search_mutex);
+		m_pondering = false;
+	}
+
+	m_search_condition.notify_one();
+}
+
 void Engine::perft(uint8_t depth)
 {
 	MoveList legal_moves = generate_legal_moves(m_position);
@@ -78,15 +174,16 @@ void Engine::perft(uint8_t depth)
 
 		total_nodes += nodes;
 
-		std::printf("%s: %llu\n", move.get_string().c_str(), nodes);
+		std::printf("%s: %llu\n", move.get_string().c_str(), static_cast<unsigned long long>(nodes));
 	}
 
-	std::printf("\nNodes searched: %llu\n\n", total_nodes);
+	std::printf("\nNodes searched: %llu\n\n", static_cast<unsigned long long>(total_nodes));
 }
 
 void Engine::set_position(Position new_position)
 {
 	m_position = new_position;
+	m_key_history.clear();
 }
 
 Position& Engine::get_position()
@@ -96,7 +193,22 @@ Position& Engine::get_position()
 
 void Engine::perform_move(const Move& move)
 {
+	m_key_history.push_back(m_position.get_hash());
 	m_position.make_move(move);
+
+	// Nothing before an irreversible move can be repeated
+	if (m_position.get_halfmove_clock() == 0)
+	{
+		m_key_history.clear();
+	}
+}
+
+void Engine::wait_for_search()
+{
+	if (m_search_thread.joinable())
+	{
+		m_search_thread.join();
+	}
 }
 
 uint64_t Engine::perft_layer(const Position& perft_position, uint8_t depth)
@@ -2,9 +2,17 @@
 #define ENGINE_ENGINE_HPP
 
 #include "position/Position.hpp"
+#include "search/SearchLimits.hpp"
+#include "search/ThreadPool.hpp"
 #include "types/Move.hpp"
 
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
 #include <random>
+#include <thread>
+#include <vector>
 
 class Engine
 {
@@ -15,18 +23,25 @@ public:
 	void shutdown();
 	void main_loop();
 
+	// Queue a command for the engine thread, main_loop runs them in order. Safe to call from any thread.
+	void post_command(std::function<void()> command);
+
 	// Engine stuff
 	void new_game();
 
-	void go();
+	// Starts the search on the search thread and returns. The best move is sent when the search is done,
+	// when pondering or searching infinitely not before ponderhit or stop.
+	void go(SearchLimits limits);
+	void stop();
+	void ponderhit();
 
 	void perft(uint8_t depth);
 
 	// Chess stuff
-	void set_position(Position new_position);
+	void set_position(Position new_position);  // Starts a new key history
 	Position& get_position();
 
-	void perform_move(const Move& move);
+	void perform_move(const Move& move);  // Also records the position left behind, for repetition detection
 
 private:
 	// Practical stuff
@@ -34,11 +49,27 @@ private:
 	std::random_device m_random_device;
 	std::mt19937 m_rng;
 
+	std::mutex m_command_mutex;
+	std::condition_variable m_command_condition;
+	std::deque<std::function<void()>> m_commands;
+
 	// Engine stuff
 	uint64_t perft_layer(const Position& perft_position, uint8_t depth);
 
+	// Blocks until the search thread has sent its best move
+	void wait_for_search();
+
+	ThreadPool m_thread_pool;  // Kept between moves so history and killers carry over
+
+	std::jthread m_search_thread;
+	std::mutex m_search_mutex;
+	std::condition_variable m_search_condition;
+	bool m_pondering = false;
+	bool m_infinite = false;
+
 	// Chess stuff
 	Position m_position;
+	std::vector<uint64_t> m_key_history;  // Hashes of the positions before m_position since the last irreversible move
 };
 
 inline Engine engine;
@@ -4,15 +4,24 @@
 
 #include <array>
 
+// Megabytes for the transposition table entries. With ABDADA the busy counters take another sixteenth on top.
 constexpr UCISetting setting_Hash(SettingID::Hash, "Hash", 1, 1, 128);
 
 constexpr UCISetting setting_RandomMovesOnly(SettingID::RandomMovesOnly, "Random moves", false);
 
-constexpr UCISetting setting_MaxSearchDepth(SettingID::MaxSearchDepth, "Search depth", 4, 1, 6);
+constexpr UCISetting setting_MaxSearchDepth(SettingID::MaxSearchDepth, "Search depth", 4, 1, 64);
 
 constexpr UCISetting setting_Logfile(SettingID::LogFilepath, "Log filepath", "");
 
-constexpr std::array<UCISetting, 4> supported_settings = {setting_Hash, setting_RandomMovesOnly, setting_MaxSearchDepth, setting_Logfile};
+constexpr UCISetting setting_Threads(SettingID::Threads, "Threads", 1, 1, 256);
+
+const UCISetting setting_ParallelSearch(SettingID::ParallelSearch, "Parallel search", "LazySMP", {"LazySMP", "ABDADA"});
+const UCISetting setting_SearchAlgorithm(SettingID::SearchAlgorithm, "Search algorithm", "AlphaBeta", {"AlphaBeta", "MCTS"});
+
+constexpr UCISetting setting_MultiPV(SettingID::MultiPV, "MultiPV", 1, 1, 256);
+
+const std::array<UCISetting, 8> supported_settings = {setting_Hash,    setting_RandomMovesOnly, setting_MaxSearchDepth, setting_Logfile,
+														setting_Threads, setting_ParallelSearch,  setting_MultiPV,        setting_SearchAlgorithm};
 
 std::string Settings::get_uci_string() const
 {
@@ -26,9 +35,9 @@ std::string Settings::get_uci_string() const
 	return full_string;
 }
 
-SettingID Settings::find_id_by_name(const std::string& name) const
+SettingID Settings::find_id_by_name(std::string_view name) const
 {
-	for (UCISetting setting : supported_settings)
+	for (const UCISetting& setting : supported_settings)
 	{
 		if (setting.match(name))
 		{
@@ -39,6 +48,16 @@ SettingID Settings::find_id_by_name(const std::string& name) const
 	return SettingID::Unknown;
 }
 
+uint32_t Settings::get_hash_size() const
+{
+	return m_hash_size;
+}
+
+void Settings::set_hash_size(uint32_t megabytes)
+{
+	m_hash_size = megabytes;
+}
+
 bool Settings::get_random_moves_only() const
 {
 	return m_random_moves_only;
@@ -57,4 +76,44 @@ uint8_t Settings::get_max_search_depth() const
 void Settings::set_max_search_depth(uint8_t depth)
 {
 	m_max_search_depth = depth;
-}
\ No newline at end of file
+}
+
+uint32_t Settings::get_thread_count() const
+{
+	return m_thread_count;
+}
+
+void Settings::set_thread_count(uint32_t thread_count)
+{
+	m_thread_count = thread_count;
+}
+
+uint32_t Settings::get_multi_pv() const
+{
+	return m_multi_pv;
+}
+
+void Settings::set_multi_pv(uint32_t line_count)
+{
+	m_multi_pv = line_count;
+}
+
+ParallelSearchType Settings::get_parallel_search_type() const
+{
+	return m_parallel_search_type;
+}
+
+void Settings::set_parallel_search_type(ParallelSearchType parallel_search_type)
+{
+	m_parallel_search_type = parallel_search_type;
+}
+
+SearchAlgorithm Settings::get_search_algorithm() const
+{
+	return m_search_algorithm;
+}
+
+void Settings::set_search_algorithm(SearchAlgorithm search_algorithm)
+{
+	m_search_algorithm = search_algorithm;
+}
@@ -2,6 +2,8 @@
 #define ENGINE_SETTINGS_HPP
 
 #include "engine/UCISetting.hpp"
+#include "search/parallel_search_type.hpp"
+#include "search/search_algorithm.hpp"
 
 class Settings
 {
@@ -10,19 +12,39 @@ public:
 
 	std::string get_uci_string() const;
 
-	SettingID find_id_by_name(const std::string& name) const;
+	SettingID find_id_by_name(std::string_view name) const;
 
 	// Setting accessors
 	bool get_random_moves_only() const;
 	void set_random_moves_only(bool value);
 
+	uint32_t get_hash_size() const;
+	void set_hash_size(uint32_t megabytes);
+
 	uint8_t get_max_search_depth() const;
 	void set_max_search_depth(uint8_t depth);
 
+	uint32_t get_thread_count() const;
+	void set_thread_count(uint32_t thread_count);
+
+	uint32_t get_multi_pv() const;
+	void set_multi_pv(uint32_t line_count);
+
+	ParallelSearchType get_parallel_search_type() const;
+	void set_parallel_search_type(ParallelSearchType parallel_search_type);
+
+	SearchAlgorithm get_search_algorithm() const;
+	void set_search_algorithm(SearchAlgorithm search_algorithm);
+
 private:
 	// Settings
+	uint32_t m_hash_size = 1;  // In MB
 	bool m_random_moves_only = false;
 	uint8_t m_max_search_depth = 1;
+	uint32_t m_thread_count = 1;
+	uint32_t m_multi_pv = 1;
+	ParallelSearchType m_parallel_search_type = ParallelSearchType::LazySMP;
+	SearchAlgorithm m_search_algorithm = SearchAlgorithm::AlphaBeta;
 };
 
 inline Settings engine_settings;
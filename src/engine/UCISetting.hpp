@@ -6,6 +6,7 @@
 
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
 enum class UCISettingType
@@ -23,7 +24,11 @@ enum class SettingID
 	Hash,
 	RandomMovesOnly,
 	MaxSearchDepth,
-	LogFilepath
+	LogFilepath,
+	Threads,
+	ParallelSearch,
+	MultiPV,
+	SearchAlgorithm
 };
 
 class UCISetting
@@ -114,7 +119,7 @@ public:
 		return m_id;
 	}
 
-	bool match(const std::string& other_name) const
+	bool match(std::string_view other_name) const
 	{
 		return string_compare(m_name, other_name);
 	}
@@ -0,0 +1,133 @@
+#include "benchmark.hpp"
+
+#include "movegen/movegen.hpp"
+#include "position/PositionString.hpp"
+#include "search/see.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Moves from the start position, all ending in positions with several exchanges available
+constexpr std::array<const char*, 3> benchmark_games = {
+	"e2e4 e7e5 g1f3 b8c6 f1c4 g8f6 d2d4 e5d4 e1g1 f6e4 f1e1 d7d5 c4d5 d8d5 b1c3",
+	"d2d4 d7d5 c2c4 e7e6 b1c3 g8f6 c1g5 f8e7 e2e3 e8g8 g1f3 b8d7 a1c1 c7c6 f1d3 d5c4 d3c4 f6d5",
+	"e2e4 c7c5 g1f3 d7d6 d2d4 c5d4 f3d4 g8f6 b1c3 a7a6 c1g5 e7e6 f2f4 d8b6 d1d2 b6b2",
+};
+
+// Middlegame and endgame positions with castling rights, en passant squares and clocks
+constexpr std::array<const char*, 4> benchmark_fens = {
+	"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+	"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+	"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+	"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 12 40",
+};
+
+std::vector<Position> get_benchmark_positions()
+{
+	std::vector<Position> positions;
+
+	for (const char* game : benchmark_games)
+	{
+		Position position = PositionString("startpos").get_position();
+
+		std::stringstream ss(game);
+		std::string move_string;
+
+		while (ss >> move_string)
+		{
+			position.make_move(parse_move_string(position, move_string));
+		}
+
+		positions.push_back(position);
+	}
+
+	return positions;
+}
+
+void benchmark_see()
+{
+	constexpr unsigned int iterations = 100000;
+
+	const std::vector<Position> positions = get_benchmark_positions();
+
+	std::vector<MoveList> moves;
+	size_t move_count = 0;
+	for (const Position& position : positions)
+	{
+		moves.push_back(generate_legal_moves(position));
+		move_count += moves.back().size();
+	}
+
+	uint64_t winning = 0;
+
+	const auto start = std::chrono::steady_clock::now();
+
+	for (unsigned int i = 0; i < iterations; i++)
+	{
+		for (size_t p = 0; p < positions.size(); p++)
+		{
+			for (const Move& move : moves[p])
+			{
+				winning += see(positions[p], move, 0);
+			}
+		}
+	}
+
+	const auto end = std::chrono::steady_clock::now();
+
+	const double nanoseconds = std::chrono::duration<double, std::nano>(end - start).count();
+	const double calls = static_cast<double>(iterations) * move_count;
+
+	std::printf("SEE: %.0f calls in %.1f ms, %.1f ns per call (%llu not losing)\n", calls, nanoseconds / 1e6, nanoseconds / calls, static_cast<unsigned long long>(winning));
+}
+
+void benchmark_fen()
+{
+	constexpr unsigned int iterations = 1000000;
+
+	Position position;
+	std::string fen;
+	unsigned int mismatches = 0;
+
+	// Everything written must read back the same
+	for (const char* benchmark_fen : benchmark_fens)
+	{
+		fen.clear();
+
+		if (parse_fen(benchmark_fen, position))
+		{
+			write_fen(position, fen);
+		}
+
+		if (fen != benchmark_fen)
+		{
+			std::printf("FEN mismatch: '%s' -> '%s'\n", benchmark_fen, fen.c_str());
+			mismatches++;
+		}
+	}
+
+	uint64_t hash_sum = 0;
+
+	const auto start = std::chrono::steady_clock::now();
+
+	for (unsigned int i = 0; i < iterations; i++)
+	{
+		for (const char* benchmark_fen : benchmark_fens)
+		{
+			parse_fen(benchmark_fen, position);
+			hash_sum += position.get_hash();
+		}
+	}
+
+	const auto end = std::chrono::steady_clock::now();
+
+	const double seconds = std::chrono::duration<double>(end - start).count();
+	const double fens = static_cast<double>(iterations) * benchmark_fens.size();
+
+	std::printf("FEN: %.0f positions in %.1f ms, %.2f M per second, %u round trip mismatches (%llx)\n", fens, seconds * 1e3, fens / seconds / 1e6, mismatches,
+				static_cast<unsigned long long>(hash_sum));
+}
@@ -0,0 +1,10 @@
+#ifndef ENGINE_BENCHMARK_HPP
+#define ENGINE_BENCHMARK_HPP
+
+// Time static exchange evaluation in isolation over the moves of a few middlegame positions
+void benchmark_see();
+
+// Time FEN parsing, after checking that a few FENs are written back as they were read
+void benchmark_fen();
+
+#endif  // ENGINE_BENCHMARK_HPP
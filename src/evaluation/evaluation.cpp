@@ -3,7 +3,7 @@
 #include "evaluation/just_material.hpp"
 #include "evaluation/simplified_evaluation_function.hpp"
 
-int evaluate_board(const Position& position, EVALUATION_TYPE evaluation_type)
+int evaluate_board_white_relative(const Position& position, EVALUATION_TYPE evaluation_type)
 {
 	switch (evaluation_type)
 	{
@@ -17,4 +17,11 @@ int evaluate_board(const Position& position, EVALUATION_TYPE evaluation_type)
 			return 0;
 	}
 	return 0;
+}
+
+int evaluate_board(const Position& position, EVALUATION_TYPE evaluation_type)
+{
+	const int evaluation = evaluate_board_white_relative(position, evaluation_type);
+
+	return (position.get_player() == Color::White) ? evaluation : -evaluation;
 }
\ No newline at end of file
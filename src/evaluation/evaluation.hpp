@@ -3,6 +3,7 @@
 #include "evaluation/evaluation_type.hpp"
 #include "position/Position.hpp"
 
+// Returns the evaluation relative to the player to move, positive is good for that player.
 int evaluate_board(const Position& position, EVALUATION_TYPE evaluation_type);
 
 #endif  // EVALUATION_EVALUATION_HPP
@@ -1,57 +1,347 @@
 #include "logging.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdarg>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
+#include <memory>
 #include <mutex>
+#include <stop_token>
+#include <string_view>
+#include <thread>
+#include <vector>
 
-constexpr size_t max_log_length = 1000;
+constexpr size_t max_log_length = 4096;  // Longer messages are cut off
 
+constexpr size_t log_ring_size = size_t{1} << 16;  // Bytes per thread, a power of two
+
+// Enough for the most search threads plus the input, engine and main threads. The rings are made when first needed.
+constexpr size_t max_log_rings = 512;
+
+// How often the background thread writes the buffers to the file
+constexpr std::chrono::milliseconds log_drain_interval(20);
+
+// In front of every message in the ring
+struct LogRecordHeader
+{
+	uint64_t sequence;  // Each batch is written in this order, so the messages of all threads are interleaved as they were logged
+	uint16_t length;
+	LogLevel level;
+};
+
+// A message read from a ring, with its text in the batch text
+struct LogRecord
+{
+	uint64_t sequence;
+	size_t offset;
+	size_t length;
+};
+
+// Single producer, single consumer. The thread that owns the ring only moves the write position, the background
+// thread only moves the read position. Positions count bytes from the start and are never wrapped.
+struct LogRing
+{
+	std::array<char, log_ring_size> data;
+	std::atomic<uint64_t> write_position = 0;
+	std::atomic<uint64_t> read_position = 0;
+	std::atomic<uint64_t> dropped = 0;  // Messages that did not fit
+
+	// Search threads are started for every search, so the ring of a finished thread goes to the next new thread
+	std::atomic<bool> in_use = false;
+};
+
+// Slots are filled once and never emptied, so threads claim rings without a lock
+struct LogRingTable
+{
+	std::array<std::atomic<LogRing*>, max_log_rings> rings{};
+
+	~LogRingTable()
+	{
+		for (std::atomic<LogRing*>& ring : rings)
+		{
+			delete ring.load(std::memory_order_relaxed);
+		}
+	}
+};
+
+LogRingTable log_ring_table;
+
+std::mutex log_mutex;  // Guards the path and the thread start, never held while logging or writing the file
 std::string log_filepath;
-std::ofstream log_file;
+bool log_filepath_changed = false;
+
+std::ofstream log_file;  // Only used by the background thread
+
+std::atomic<bool> logging_enabled = false;
+std::atomic<uint64_t> log_sequence = 0;
+std::atomic<uint64_t> log_dropped_without_ring = 0;  // Messages of threads that found every ring taken
+
+std::condition_variable_any log_drain_condition;
 
-std::mutex log_mutex;
+void drain_log_rings(std::stop_token stop_token);
 
-void log(const std::string& log_string)
+// Declared last, so it is destroyed first and writes what is left while everything it uses still exists
+std::jthread log_drain_thread;
+
+void copy_to_ring(LogRing& ring, uint64_t position, const void* source, size_t length)
 {
-	std::lock_guard lock(log_mutex);
+	const size_t offset = position & (log_ring_size - 1);
+	const size_t first_part = std::min(length, log_ring_size - offset);
+
+	std::memcpy(ring.data.data() + offset, source, first_part);
+	std::memcpy(ring.data.data(), static_cast<const char*>(source) + first_part, length - first_part);
+}
+
+void copy_from_ring(const LogRing& ring, uint64_t position, void* destination, size_t length)
+{
+	const size_t offset = position & (log_ring_size - 1);
+	const size_t first_part = std::min(length, log_ring_size - offset);
+
+	std::memcpy(destination, ring.data.data() + offset, first_part);
+	std::memcpy(static_cast<char*>(destination) + first_part, ring.data.data(), length - first_part);
+}
+
+// Gives the ring back when the thread ends
+struct LogRingOwner
+{
+	LogRing* ring = nullptr;
+
+	~LogRingOwner()
+	{
+		if (ring != nullptr)
+		{
+			ring->in_use.store(false, std::memory_order_release);
+		}
+	}
+};
 
-	if (!log_file.is_open())
+LogRing* claim_log_ring()
+{
+	for (std::atomic<LogRing*>& slot : log_ring_table.rings)
 	{
-		if (log_filepath == "")
+		LogRing* ring = slot.load(std::memory_order_acquire);
+
+		if (ring == nullptr)
 		{
-			return;
+			auto new_ring = std::make_unique<LogRing>();
+			new_ring->in_use.store(true, std::memory_order_relaxed);
+
+			if (slot.compare_exchange_strong(ring, new_ring.get(), std::memory_order_acq_rel))
+			{
+				return new_ring.release();
+			}
+
+			// Another thread filled the slot first, ring is now its ring and may still be free
 		}
 
-		log_file.open(log_filepath);
+		bool in_use = false;
+
+		if (ring->in_use.compare_exchange_strong(in_use, true, std::memory_order_acquire))
+		{
+			return ring;
+		}
 	}
 
-	log_file << log_string;
+	return nullptr;
+}
+
+// nullptr while every ring is taken
+LogRing* get_thread_log_ring()
+{
+	thread_local LogRingOwner owner;
+
+	if (owner.ring == nullptr)
+	{
+		owner.ring = claim_log_ring();
+	}
 
-	log_file.flush();
+	return owner.ring;
 }
 
-void log_msg(const char* format, ...)
+void write_log(LogLevel level, const char* format, ...)
 {
-	char msg[max_log_length];
+	if (!logging_enabled.load(std::memory_order_relaxed))
+	{
+		return;
+	}
+
+	thread_local std::array<char, max_log_length> message;
 
 	va_list args;
 	va_start(args, format);
+	const int written = std::vsnprintf(message.data(), message.size(), format, args);
+	va_end(args);
+
+	if (written < 0)
+	{
+		return;
+	}
+
+	const LogRecordHeader header = {log_sequence.fetch_add(1, std::memory_order_relaxed), static_cast<uint16_t>(std::min<size_t>(written, message.size() - 1)), level};
+	const size_t record_size = sizeof(header) + header.length;
 
-	std::vsnprintf(msg, sizeof msg, format, args);
+	LogRing* ring_pointer = get_thread_log_ring();
 
-	log(std::string{"Log: "} + msg + std::string{"\n\n"});
+	if (ring_pointer == nullptr)
+	{
+		log_dropped_without_ring.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	LogRing& ring = *ring_pointer;
+
+	const uint64_t write_position = ring.write_position.load(std::memory_order_relaxed);
+	const uint64_t read_position = ring.read_position.load(std::memory_order_acquire);
+
+	if (write_position + record_size - read_position > log_ring_size)
+	{
+		ring.dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	copy_to_ring(ring, write_position, &header, sizeof(header));
+	copy_to_ring(ring, write_position + sizeof(header), message.data(), header.length);
+
+	ring.write_position.store(write_position + record_size, std::memory_order_release);
 }
 
-void log_error(const char* format, ...)
+std::string_view get_log_prefix(LogLevel level)
 {
-	char msg[max_log_length];
+	switch (level)
+	{
+		case LogLevel::Debug:
+		{
+			return "Debug: ";
+		}
+		case LogLevel::Info:
+		{
+			return "Log: ";
+		}
+		default:
+		{
+			return "Error: ";
+		}
+	}
+}
 
-	va_list args;
-	va_start(args, format);
+void add_dropped_record(uint64_t dropped, std::string_view reason, std::string& text, std::vector<LogRecord>& records)
+{
+	if (dropped == 0)
+	{
+		return;
+	}
+
+	const size_t offset = text.size();
+	text += "Error: " + std::to_string(dropped) + " messages dropped, ";
+	text += reason;
+	text += "\n\n";
+	records.push_back({log_sequence.load(std::memory_order_relaxed), offset, text.size() - offset});
+}
+
+// Moves the messages of one ring to the batch text, formatted as they go to the file
+void read_log_ring(LogRing& ring, std::string& text, std::vector<LogRecord>& records)
+{
+	uint64_t read_position = ring.read_position.load(std::memory_order_relaxed);
+	const uint64_t write_position = ring.write_position.load(std::memory_order_acquire);
+
+	while (read_position < write_position)
+	{
+		LogRecordHeader header;
+		copy_from_ring(ring, read_position, &header, sizeof(header));
+
+		const size_t offset = text.size();
+		text += get_log_prefix(header.level);
+		text.resize(text.size() + header.length);
+		copy_from_ring(ring, read_position + sizeof(header), text.data() + text.size() - header.length, header.length);
+		text += "\n\n";
 
-	std::vsnprintf(msg, sizeof msg, format, args);
+		records.push_back({header.sequence, offset, text.size() - offset});
+		read_position += sizeof(header) + header.length;
+	}
+
+	ring.read_position.store(read_position, std::memory_order_release);
 
-	log(std::string{"Error: "} + msg + std::string{"\n\n"});
+	add_dropped_record(ring.dropped.exchange(0, std::memory_order_relaxed), "the log buffer was full", text, records);
+}
+
+void drain_log_rings(std::stop_token stop_token)
+{
+	// Kept between batches so their capacity is reused
+	std::string text;
+	std::vector<LogRecord> records;
+	std::string batch;
+
+	std::string filepath;
+
+	while (true)
+	{
+		bool filepath_changed = false;
+
+		{
+			std::unique_lock lock(log_mutex);
+			log_drain_condition.wait_for(lock, stop_token, log_drain_interval, []() { return false; });
+
+			if (log_filepath_changed)
+			{
+				filepath = log_filepath;
+				filepath_changed = true;
+				log_filepath_changed = false;
+			}
+		}
+
+		// Stopping still writes what was logged before
+		const bool stopping = stop_token.stop_requested();
+
+		if (filepath_changed)
+		{
+			log_file.close();
+
+			if (!filepath.empty())
+			{
+				log_file.open(filepath);
+			}
+		}
+
+		text.clear();
+		records.clear();
+
+		for (std::atomic<LogRing*>& slot : log_ring_table.rings)
+		{
+			LogRing* ring = slot.load(std::memory_order_acquire);
+
+			if (ring != nullptr)
+			{
+				read_log_ring(*ring, text, records);
+			}
+		}
+
+		add_dropped_record(log_dropped_without_ring.exchange(0, std::memory_order_relaxed), "too many threads were logging", text, records);
+
+		std::sort(records.begin(), records.end(), [](const LogRecord& a, const LogRecord& b) { return a.sequence < b.sequence; });
+
+		batch.clear();
+
+		for (const LogRecord& record : records)
+		{
+			batch.append(text, record.offset, record.length);
+		}
+
+		if (!batch.empty() && log_file.is_open())
+		{
+			log_file.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+			log_file.flush();
+		}
+
+		if (stopping)
+		{
+			break;
+		}
+	}
 }
 
 void set_log_filepath(const std::string& filepath)
@@ -63,10 +353,12 @@ void set_log_filepath(const std::string& filepath)
 		return;
 	}
 
-	if (log_file.is_open())
+	log_filepath = filepath;
+	log_filepath_changed = true;
+	logging_enabled.store(!filepath.empty(), std::memory_order_relaxed);
+
+	if (!log_drain_thread.joinable())
 	{
-		log_file.close();
+		log_drain_thread = std::jthread(drain_log_rings);
 	}
-
-	log_filepath = filepath;
-}
\ No newline at end of file
+}
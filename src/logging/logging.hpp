@@ -1,11 +1,57 @@
 #ifndef LOGGING_LOGGING_HPP
 #define LOGGING_LOGGING_HPP
 
+#include <cstdint>
 #include <string>
 
-void log_msg(const char* format, ...);
-void log_error(const char* format, ...);
+enum class LogLevel : uint8_t
+{
+	Debug = 0,
+	Info = 1,
+	Error = 2,
+	None = 3  // Only as threshold, compiles out every message
+};
 
+// Messages below this level are compiled out, arguments and all. Build with -DTHINKER_LOG_LEVEL=0 for debug messages.
+#ifndef THINKER_LOG_LEVEL
+#define THINKER_LOG_LEVEL 1
+#endif
+
+constexpr LogLevel min_log_level = static_cast<LogLevel>(THINKER_LOG_LEVEL);
+
+// Formats the message into the ring buffer of the calling thread, a background thread writes the buffers to the log
+// file in batches. Never blocks, a thread claims its buffer without a lock, and a message that does not fit in a full
+// buffer is dropped and counted. Does nothing while no log file is set. Use the level functions below.
+void write_log(LogLevel level, const char* format, ...);
+
+template <typename... Args>
+void log_debug(const char* format, Args... args)
+{
+	if constexpr (LogLevel::Debug >= min_log_level)
+	{
+		write_log(LogLevel::Debug, format, args...);
+	}
+}
+
+template <typename... Args>
+void log_msg(const char* format, Args... args)
+{
+	if constexpr (LogLevel::Info >= min_log_level)
+	{
+		write_log(LogLevel::Info, format, args...);
+	}
+}
+
+template <typename... Args>
+void log_error(const char* format, Args... args)
+{
+	if constexpr (LogLevel::Error >= min_log_level)
+	{
+		write_log(LogLevel::Error, format, args...);
+	}
+}
+
+// Starts logging to the file, an empty path stops logging
 void set_log_filepath(const std::string& filepath);
 
 #endif  // LOGGING_LOGGING_HPP
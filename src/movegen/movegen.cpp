@@ -3,33 +3,66 @@
 #include "logging/logging.hpp"
 #include "movegen/movegen.hpp"
 #include "position/PositionAnalysis.hpp"
+#include "types/conversions.hpp"
+
+static bool leaves_king_in_check(const Position& position, const Move& move)
+{
+	Position new_pos = position;
+	new_pos.make_move(move);
+
+	return PositionAnalysis(new_pos).king_in_check();
+}
 
 MoveList generate_legal_moves(const Position& position)
 {
-	MoveList pseudolegal_moves = generate_pseudolegal_moves(position);
+	MoveList moves;
+	generate_legal_moves(position, moves);
+	return moves;
+}
 
-	MoveList legal_moves;
-	for (const Move& move : pseudolegal_moves)
-	{
-		Position new_pos = position;
-		new_pos.make_move(move);
+void generate_legal_moves(const Position& position, MoveList& moves)
+{
+	generate_pseudolegal_moves(position, moves);
 
-		PositionAnalysis analysis(new_pos);
+	std::erase_if(moves, [&position](const Move& move) { return leaves_king_in_check(position, move); });
 
-		if (!analysis.king_in_check())
-		{
-			legal_moves.push_back(move);
-		}
-	}
+	generate_castling_move(position, moves);
+}
 
-	generate_castling_move(position, legal_moves);
+MoveList generate_legal_captures(const Position& position)
+{
+	MoveList captures;
+	generate_legal_captures(position, captures);
+	return captures;
+}
 
-	return legal_moves;
+void generate_legal_captures(const Position& position, MoveList& captures)
+{
+	generate_pseudolegal_moves(position, captures);
+
+	std::erase_if(captures,
+				  [&position](const Move& move)
+				  {
+					  // Filter before the legality check, that is the expensive part
+					  if (!position.is_capture(move) && convert_promo_to_piece(move.get_type()) == Piece::Empty)
+					  {
+						  return true;
+					  }
+
+					  return leaves_king_in_check(position, move);
+				  });
 }
 
 MoveList generate_pseudolegal_moves(const Position& position)
 {
 	MoveList moves;
+	generate_pseudolegal_moves(position, moves);
+	return moves;
+}
+
+void generate_pseudolegal_moves(const Position& position, MoveList& moves)
+{
+	moves.clear();
 
 	Color player = position.get_player();
 
@@ -85,8 +118,6 @@ MoveList generate_pseudolegal_moves(const Position& position)
 			}
 		}
 	}
-
-	return moves;
 }
 
 bool should_use_forward_scan(Ray ray)
@@ -140,4 +171,57 @@ Bitboard generate_diagonal_rays(const Position& position, Square from_square)
 	Bitboard southwest = generate_from_ray(position, from_square, Ray::SW);
 
 	return northeast | northwest | southeast | southwest;
+}
+
+Bitboard generate_ray_attacks(Square from_square, Ray ray, Bitboard occupancy)
+{
+	Bitboard full_ray = movegen_rays[static_cast<uint8_t>(ray)][from_square.get_data()];
+
+	Bitboard collisions = full_ray & occupancy;
+
+	if (collisions.empty())
+	{
+		return full_ray;
+	}
+
+	Square first_collision(should_use_forward_scan(ray) ? collisions.scan_forward() : collisions.scan_backward());
+
+	return full_ray & ~movegen_rays[static_cast<uint8_t>(ray)][first_collision.get_data()];
+}
+
+Bitboard generate_orthogonal_attacks(Square from_square, Bitboard occupancy)
+{
+	return generate_ray_attacks(from_square, Ray::E, occupancy) | generate_ray_attacks(from_square, Ray::S, occupancy) | generate_ray_attacks(from_square, Ray::W, occupancy) |
+		   generate_ray_attacks(from_square, Ray::N, occupancy);
+}
+
+Bitboard generate_diagonal_attacks(Square from_square, Bitboard occupancy)
+{
+	return generate_ray_attacks(from_square, Ray::NE, occupancy) | generate_ray_attacks(from_square, Ray::NW, occupancy) | generate_ray_attacks(from_square, Ray::SE, occupancy) |
+		   generate_ray_attacks(from_square, Ray::SW, occupancy);
+}
+
+Bitboard attackers_to(const Position& position, Square square, Bitboard occupancy)
+{
+	const uint8_t index = square.get_data();
+
+	const Bitboard queens = position.get_bitboard(Piece::Queen);
+	const Bitboard diagonal_sliders = position.get_bitboard(Piece::Bishop) | queens;
+	const Bitboard orthogonal_sliders = position.get_bitboard(Piece::Rook) | queens;
+
+	// Pawns attack from the diagonally adjacent squares behind the square, seen from their side
+	const Bitboard adjacent = movegen_rays[static_cast<uint8_t>(Ray::King)][index];
+	const Bitboard below = movegen_rays[static_cast<uint8_t>(Ray::SE)][index] | movegen_rays[static_cast<uint8_t>(Ray::SW)][index];
+	const Bitboard above = movegen_rays[static_cast<uint8_t>(Ray::NE)][index] | movegen_rays[static_cast<uint8_t>(Ray::NW)][index];
+
+	const Bitboard pawns = position.get_bitboard(Piece::Pawn);
+	const Bitboard white_pawns = adjacent & below & pawns & position.get_bitboard(Color::White);
+	const Bitboard black_pawns = adjacent & above & pawns & position.get_bitboard(Color::Black);
+
+	const Bitboard knights = movegen_rays[static_cast<uint8_t>(Ray::Knight)][index] & position.get_bitboard(Piece::Knight);
+	const Bitboard kings = movegen_rays[static_cast<uint8_t>(Ray::King)][index] & position.get_bitboard(Piece::King);
+
+	const Bitboard sliders = (generate_diagonal_attacks(square, occupancy) & diagonal_sliders) | (generate_orthogonal_attacks(square, occupancy) & orthogonal_sliders);
+
+	return (white_pawns | black_pawns | knights | kings | sliders) & occupancy;
 }
\ No newline at end of file
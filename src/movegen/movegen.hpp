@@ -8,10 +8,21 @@
 
 using MoveList = std::vector<Move>;  // Inefficient
 
+constexpr size_t max_moves = 256;  // More than the legal moves in any position
+
 MoveList generate_pseudolegal_moves(const Position& position);
 
 MoveList generate_legal_moves(const Position& position);
 
+// Legal captures and promotions only, for quiescence search
+MoveList generate_legal_captures(const Position& position);
+
+// Same as above, but the moves replace the contents of a buffer owned by the caller. The search reuses buffers reserved
+// for max_moves, so generating moves allocates nothing.
+void generate_pseudolegal_moves(const Position& position, MoveList& moves);
+void generate_legal_moves(const Position& position, MoveList& moves);
+void generate_legal_captures(const Position& position, MoveList& captures);
+
 template <Piece piece>
 void generate_move(const Position& position, Square from_square, MoveList& moves);
 
@@ -25,4 +36,14 @@ Bitboard generate_orthogonal_rays(const Position& position, Square from_square);
 
 Bitboard generate_diagonal_rays(const Position& position, Square from_square);
 
+// Squares a slider on from_square attacks along the ray with the given occupancy, including the first blocker
+Bitboard generate_ray_attacks(Square from_square, Ray ray, Bitboard occupancy);
+
+Bitboard generate_orthogonal_attacks(Square from_square, Bitboard occupancy);
+
+Bitboard generate_diagonal_attacks(Square from_square, Bitboard occupancy);
+
+// Pieces of both colors attacking the square, only considering pieces in occupancy. Removing pieces from occupancy reveals x-ray attackers.
+Bitboard attackers_to(const Position& position, Square square, Bitboard occupancy);
+
 #endif  // MOVEGEN_MOVEGEN_HPP
@@ -1,6 +1,7 @@
 #include "Position.hpp"
 
 #include "logging/logging.hpp"
+#include "position/zobrist.hpp"
 #include "types/conversions.hpp"
 
 Position::Position()
@@ -12,6 +13,12 @@ void Position::reset()
 {
 	m_bitboard_by_piece = BitboardByPiece();
 	m_bitboard_by_color = BitboardByColor();
+
+	// What compute_hash gives for an empty board, without visiting every square
+	m_hash = zobrist_keys.castling[get_castling_rights()] ^ ((get_player() == Color::Black) ? zobrist_keys.black_to_move : 0);
+	m_halfmove_clock = 0;
+	m_plies_from_null = 0;
+	m_fullmove_number = 1;
 }
 
 void Position::setup_standard_position()
@@ -66,6 +73,9 @@ void Position::make_move(const Move& move)
 		return;
 	}
 
+	const Piece captured_piece = get_piece(to_square);
+	const uint8_t castling_rights_before = get_castling_rights();
+
 	// Remove piece from from square
 	m_bitboard_by_color.clear_all_by_square(from_square);
 	m_bitboard_by_piece.clear_all_by_square(from_square);
@@ -83,6 +93,14 @@ void Position::make_move(const Move& move)
 	m_bitboard_by_color[color].set_by_square(to_square);
 	m_bitboard_by_piece[to_piece].set_by_square(to_square);
 
+	m_hash ^= get_zobrist_piece_key(color, piece, from_square);
+	m_hash ^= get_zobrist_piece_key(color, to_piece, to_square);
+
+	if (captured_piece != Piece::Empty)
+	{
+		m_hash ^= get_zobrist_piece_key(get_other_color(color), captured_piece, to_square);
+	}
+
 	MoveType type = move.get_type();
 
 	// Perform rook move if castling
@@ -97,6 +115,8 @@ void Position::make_move(const Move& move)
 		Square rook_to_square(FILE_D, to_square.get_rank());
 		m_bitboard_by_color[color].set_by_square(rook_to_square);
 		m_bitboard_by_piece[Piece::Rook].set_by_square(rook_to_square);
+
+		m_hash ^= get_zobrist_piece_key(color, Piece::Rook, rook_from_square) ^ get_zobrist_piece_key(color, Piece::Rook, rook_to_square);
 	}
 
 	if (type == MoveType::KingCastle)
@@ -110,6 +130,8 @@ void Position::make_move(const Move& move)
 		Square rook_to_square(FILE_F, to_square.get_rank());
 		m_bitboard_by_color[color].set_by_square(rook_to_square);
 		m_bitboard_by_piece[Piece::Rook].set_by_square(rook_to_square);
+
+		m_hash ^= get_zobrist_piece_key(color, Piece::Rook, rook_from_square) ^ get_zobrist_piece_key(color, Piece::Rook, rook_to_square);
 	}
 
 	// Remove castling rights
@@ -141,7 +163,26 @@ void Position::make_move(const Move& move)
 		m_kingside_castling[static_cast<uint8_t>(Color::Black)] = false;
 	}
 
+	m_hash ^= zobrist_keys.castling[castling_rights_before] ^ zobrist_keys.castling[get_castling_rights()];
+
+	// Captures and pawn moves cannot be undone, no earlier position can be repeated
+	if (captured_piece != Piece::Empty || piece == Piece::Pawn)
+	{
+		m_halfmove_clock = 0;
+	}
+	else
+	{
+		m_halfmove_clock++;
+	}
+	m_plies_from_null++;
+
+	if (m_player == Color::Black)
+	{
+		m_fullmove_number++;
+	}
+
 	m_player = get_other_color(m_player);
+	m_hash ^= zobrist_keys.black_to_move;
 }
 
 void Position::unmake_move(const Move& move)
@@ -149,6 +190,27 @@ void Position::unmake_move(const Move& move)
 	(void)move;
 }
 
+void Position::make_null_move()
+{
+	m_player = get_other_color(m_player);
+	m_hash ^= zobrist_keys.black_to_move;
+	m_plies_from_null = 0;
+}
+
+void Position::unmake_null_move()
+{
+	// Only the player is restored, the search copies the position instead of unmaking null moves
+	m_player = get_other_color(m_player);
+	m_hash ^= zobrist_keys.black_to_move;
+}
+
+bool Position::has_non_pawn_material(Color color) const
+{
+	const Bitboard pieces = get_bitboard(Piece::Knight) | get_bitboard(Piece::Bishop) | get_bitboard(Piece::Rook) | get_bitboard(Piece::Queen);
+
+	return !(pieces & get_bitboard(color)).empty();
+}
+
 Piece Position::get_piece(Square square) const
 {
 	return m_bitboard_by_piece.find_on_square(square);
@@ -159,10 +221,74 @@ Color Position::get_color(Square square) const
 	return m_bitboard_by_color.find_on_square(square);
 }
 
+bool Position::is_capture(const Move& move) const
+{
+	return get_color(move.get_to_square()) == get_other_color(get_player()) || move.get_type() == MoveType::EnPassant;
+}
+
+uint64_t Position::get_hash() const
+{
+	return m_hash;
+}
+
+unsigned int Position::get_halfmove_clock() const
+{
+	return m_halfmove_clock;
+}
+
+void Position::set_halfmove_clock(unsigned int halfmove_clock)
+{
+	m_halfmove_clock = static_cast<uint16_t>(halfmove_clock);
+}
+
+unsigned int Position::get_fullmove_number() const
+{
+	return m_fullmove_number;
+}
+
+void Position::set_fullmove_number(unsigned int fullmove_number)
+{
+	m_fullmove_number = static_cast<uint16_t>(fullmove_number);
+}
+
+unsigned int Position::get_plies_from_null() const
+{
+	return m_plies_from_null;
+}
+
+uint64_t Position::compute_hash() const
+{
+	uint64_t hash = zobrist_keys.castling[get_castling_rights()];
+
+	if (get_player() == Color::Black)
+	{
+		hash ^= zobrist_keys.black_to_move;
+	}
+
+	for (uint8_t i = 0; i < 64; i++)
+	{
+		Square square(i);
+		Piece piece = get_piece(square);
+
+		if (piece != Piece::Empty)
+		{
+			hash ^= get_zobrist_piece_key(get_color(square), piece, square);
+		}
+	}
+
+	return hash;
+}
+
+uint8_t Position::get_castling_rights() const
+{
+	return (may_white_queenside_castle() ? 1 : 0) | (may_white_kingside_castle() ? 2 : 0) | (may_black_queenside_castle() ? 4 : 0) | (may_black_kingside_castle() ? 8 : 0);
+}
+
 void Position::set_square(Square square, Color color, Piece piece)
 {
 	m_bitboard_by_piece[piece].set_by_square(square);
 	m_bitboard_by_color[color].set_by_square(square);
+	m_hash ^= get_zobrist_piece_key(color, piece, square);
 }
 
 Color Position::get_player() const
@@ -200,8 +326,23 @@ bool Position::may_black_kingside_castle() const
 	return m_kingside_castling[static_cast<uint8_t>(Color::Black)];
 }
 
+void Position::set_castling_rights(bool white_kingside, bool white_queenside, bool black_kingside, bool black_queenside)
+{
+	const uint8_t castling_rights_before = get_castling_rights();
+
+	m_kingside_castling = {white_kingside, black_kingside};
+	m_queenside_castling = {white_queenside, black_queenside};
+
+	m_hash ^= zobrist_keys.castling[castling_rights_before] ^ zobrist_keys.castling[get_castling_rights()];
+}
+
 void Position::set_player(Color new_color)
 {
+	if (new_color != m_player)
+	{
+		m_hash ^= zobrist_keys.black_to_move;
+	}
+
 	m_player = new_color;
 }
 
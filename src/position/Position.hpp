@@ -5,6 +5,7 @@
 #include "types/Move.hpp"
 
 #include <array>
+#include <cstdint>
 
 class Position
 {
@@ -18,9 +19,31 @@ public:
 	void make_move(const Move& move);
 	void unmake_move(const Move& move);  // Is this implementation possible in this context? Is it needed?
 
+	// Pass the turn to the opponent, for null move pruning
+	void make_null_move();
+	void unmake_null_move();
+
+	bool has_non_pawn_material(Color color) const;
+
 	Piece get_piece(Square square) const;
 	Color get_color(Square square) const;
 
+	bool is_capture(const Move& move) const;
+
+	uint64_t get_hash() const;
+	uint64_t compute_hash() const;  // Full recomputation, the stored hash is updated incrementally
+
+	// Plies since the last capture or pawn move, for the fifty-move rule
+	unsigned int get_halfmove_clock() const;
+	void set_halfmove_clock(unsigned int halfmove_clock);
+
+	// Starts at 1 and goes up after every move of black, as in FEN
+	unsigned int get_fullmove_number() const;
+	void set_fullmove_number(unsigned int fullmove_number);
+
+	// Plies since the last null move. Positions before a null move cannot be repeated through real moves.
+	unsigned int get_plies_from_null() const;
+
 	void set_square(Square square, Color color, Piece piece);
 
 	Bitboard get_bitboard(Color color) const;
@@ -37,7 +60,11 @@ public:
 	bool may_black_queenside_castle() const;
 	bool may_black_kingside_castle() const;
 
+	void set_castling_rights(bool white_kingside, bool white_queenside, bool black_kingside, bool black_queenside);
+
 private:
+	uint8_t get_castling_rights() const;  // Bitmask for indexing Zobrist keys
+
 	BitboardByPiece m_bitboard_by_piece;
 	BitboardByColor m_bitboard_by_color;
 
@@ -45,6 +72,12 @@ private:
 	Color m_player = Color::White;
 	std::array<bool, 2> m_queenside_castling = {true, true};  // Indexed by Color
 	std::array<bool, 2> m_kingside_castling = {true, true};
+
+	uint64_t m_hash = 0;
+
+	uint16_t m_halfmove_clock = 0;
+	uint16_t m_plies_from_null = 0;
+	uint16_t m_fullmove_number = 1;
 };
 
 #endif  // POSITION_POSITION_HPP
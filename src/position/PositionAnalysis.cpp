@@ -33,6 +33,22 @@ bool PositionAnalysis::king_in_check() const
 	return false;
 }
 
+bool PositionAnalysis::player_in_check() const
+{
+	const Color player = m_position.get_player();
+	const Bitboard king = m_position.get_bitboard(Piece::King) & m_position.get_bitboard(player);
+
+	if (king.empty())
+	{
+		return false;
+	}
+
+	const Bitboard occupancy = m_position.get_bitboard(Color::White) | m_position.get_bitboard(Color::Black);
+	const Bitboard attackers = attackers_to(m_position, Square(king.scan_forward()), occupancy) & m_position.get_bitboard(get_other_color(player));
+
+	return !attackers.empty();
+}
+
 Bitboard PositionAnalysis::threatened_squares() const
 {
 	MoveList pseudolegal_moves = generate_pseudolegal_moves(m_position);
@@ -9,7 +9,8 @@ public:
 	PositionAnalysis() = delete;
 	PositionAnalysis(const Position& position);
 
-	bool king_in_check() const;
+	bool king_in_check() const;  // Is the opponent's king attacked by the player to move?
+	bool player_in_check() const;  // Is the king of the player to move attacked?
 	Bitboard threatened_squares() const;
 
 private:
@@ -1,15 +1,537 @@
 #include "PositionString.hpp"
 
-PositionString::PositionString(const std::string& string)
+#include "logging/logging.hpp"
+#include "types/conversions.hpp"
+#include "util/string_utils.hpp"
+
+#include <algorithm>
+#include <charconv>
+
+struct FenPiece
+{
+	Color color = Color::Empty;
+	Piece piece = Piece::Empty;
+};
+
+// Indexed by the FEN character, so a square is read with a single lookup
+constexpr std::array<FenPiece, 128> fen_pieces = []()
+{
+	std::array<FenPiece, 128> pieces{};
+
+	constexpr std::string_view piece_chars = "pnbrqk";
+
+	for (uint8_t i = 0; i < piece_chars.size(); i++)
+	{
+		const Piece piece = static_cast<Piece>(i);
+
+		pieces[static_cast<uint8_t>(piece_chars[i])] = {Color::Black, piece};
+		pieces[static_cast<uint8_t>(piece_chars[i] - 'a' + 'A')] = {Color::White, piece};
+	}
+
+	return pieces;
+}();
+
+constexpr size_t fen_error = std::string_view::npos;
+
+size_t skip_spaces(std::string_view text, size_t i)
+{
+	while (i < text.size() && (text[i] == ' ' || text[i] == '\t'))
+	{
+		i++;
+	}
+
+	return i;
+}
+
+bool is_field_end(std::string_view text, size_t i)
+{
+	return i >= text.size() || text[i] == ' ' || text[i] == '\t';
+}
+
+bool has_piece(const Position& position, Square square, Color color, Piece piece)
+{
+	return (position.get_bitboard(piece) & position.get_bitboard(color)).read_by_square(square);
+}
+
+// Reads the board, player, castling and en passant fields from the start of the text.
+// Returns where they end, fen_error if they are not valid.
+size_t parse_fen_fields(std::string_view text, Position& position)
+{
+	position.reset();
+
+	size_t i = skip_spaces(text, 0);
+
+	// Board, from a8 to h1
+	uint8_t rank = RANK_8;
+	uint8_t file = FILE_A;
+
+	for (; !is_field_end(text, i); i++)
+	{
+		const char c = text[i];
+
+		if (c == '/')
+		{
+			if (file != FILE_H + 1 || rank == RANK_1)
+			{
+				return fen_error;
+			}
+
+			rank--;
+			file = FILE_A;
+		}
+		else if (c >= '1' && c <= '8')
+		{
+			file += c - '0';
+
+			if (file > FILE_H + 1)
+			{
+				return fen_error;
+			}
+		}
+		else
+		{
+			const FenPiece fen_piece = (static_cast<unsigned char>(c) < fen_pieces.size()) ? fen_pieces[static_cast<unsigned char>(c)] : FenPiece();
+
+			if (fen_piece.piece == Piece::Empty || file > FILE_H)
+			{
+				return fen_error;
+			}
+
+			position.set_square(Square(file, rank), fen_piece.color, fen_piece.piece);
+			file++;
+		}
+	}
+
+	if (rank != RANK_1 || file != FILE_H + 1)
+	{
+		return fen_error;
+	}
+
+	// Move generation relies on there being one king of each color
+	for (const Color color : {Color::White, Color::Black})
+	{
+		if ((position.get_bitboard(Piece::King) & position.get_bitboard(color)).read_bitcount() != 1)
+		{
+			return fen_error;
+		}
+	}
+
+	// Player
+	i = skip_spaces(text, i);
+
+	if (i >= text.size() || (text[i] != 'w' && text[i] != 'b') || !is_field_end(text, i + 1))
+	{
+		return fen_error;
+	}
+
+	position.set_player((text[i] == 'w') ? Color::White : Color::Black);
+	i++;
+
+	// Castling
+	i = skip_spaces(text, i);
+
+	bool white_kingside = false;
+	bool white_queenside = false;
+	bool black_kingside = false;
+	bool black_queenside = false;
+
+	if (i < text.size() && text[i] == '-')
+	{
+		i++;
+	}
+	else
+	{
+		const size_t start = i;
+
+		for (; !is_field_end(text, i); i++)
+		{
+			switch (text[i])
+			{
+				case 'K':
+				{
+					white_kingside = true;
+					break;
+				}
+				case 'Q':
+				{
+					white_queenside = true;
+					break;
+				}
+				case 'k':
+				{
+					black_kingside = true;
+					break;
+				}
+				case 'q':
+				{
+					black_queenside = true;
+					break;
+				}
+				default:
+				{
+					return fen_error;
+				}
+			}
+		}
+
+		if (i == start)
+		{
+			return fen_error;
+		}
+	}
+
+	if (!is_field_end(text, i))
+	{
+		return fen_error;
+	}
+
+	// Rights without the king and rook at home are dropped, castling would move pieces that are not there
+	const bool white_king_home = has_piece(position, Square(FILE_E, RANK_1), Color::White, Piece::King);
+	const bool black_king_home = has_piece(position, Square(FILE_E, RANK_8), Color::Black, Piece::King);
+
+	position.set_castling_rights(white_kingside && white_king_home && has_piece(position, Square(FILE_H, RANK_1), Color::White, Piece::Rook),
+								 white_queenside && white_king_home && has_piece(position, Square(FILE_A, RANK_1), Color::White, Piece::Rook),
+								 black_kingside && black_king_home && has_piece(position, Square(FILE_H, RANK_8), Color::Black, Piece::Rook),
+								 black_queenside && black_king_home && has_piece(position, Square(FILE_A, RANK_8), Color::Black, Piece::Rook));
+
+	// En passant. Checked, but not kept, move generation does not play en passant captures.
+	i = skip_spaces(text, i);
+
+	if (i < text.size() && text[i] == '-')
+	{
+		i++;
+	}
+	else
+	{
+		const char en_passant_rank = (position.get_player() == Color::White) ? '6' : '3';
+
+		if (i + 1 >= text.size() || text[i] < 'a' || text[i] > 'h' || text[i + 1] != en_passant_rank)
+		{
+			return fen_error;
+		}
+
+		i += 2;
+	}
+
+	if (!is_field_end(text, i) && text[i] != ';')
+	{
+		return fen_error;
+	}
+
+	return i;
+}
+
+// Reads a number ending at a space, a ';' or the end of the text. Returns where it ends, fen_error if there is none.
+size_t parse_clock(std::string_view text, size_t i, unsigned int& value)
+{
+	const auto [end, error] = std::from_chars(text.data() + i, text.data() + text.size(), value);
+
+	const size_t end_index = static_cast<size_t>(end - text.data());
+
+	if (error != std::errc() || (!is_field_end(text, end_index) && text[end_index] != ';'))
+	{
+		return fen_error;
+	}
+
+	return end_index;
+}
+
+// Reads the halfmove clock and the fullmove number if they are there. Returns where they end, fen_error if they are not valid.
+size_t parse_fen_clocks(std::string_view text, size_t i, Position& position)
+{
+	unsigned int halfmove_clock = 0;
+	unsigned int fullmove_number = 1;
+
+	i = skip_spaces(text, i);
+
+	if (i < text.size() && text[i] >= '0' && text[i] <= '9')
+	{
+		i = parse_clock(text, i, halfmove_clock);
+
+		if (i == fen_error)
+		{
+			return fen_error;
+		}
+
+		i = skip_spaces(text, i);
+
+		if (i < text.size() && text[i] >= '0' && text[i] <= '9')
+		{
+			i = parse_clock(text, i, fullmove_number);
+
+			if (i == fen_error)
+			{
+				return fen_error;
+			}
+		}
+	}
+
+	position.set_halfmove_clock(halfmove_clock);
+	position.set_fullmove_number(std::max(fullmove_number, 1u));
+
+	return i;
+}
+
+bool parse_fen(std::string_view fen, Position& position)
 {
+	size_t i = parse_fen_fields(fen, position);
+
+	if (i == fen_error)
+	{
+		return false;
+	}
+
+	i = parse_fen_clocks(fen, i, position);
+
+	return i != fen_error && skip_spaces(fen, i) == fen.size();
+}
+
+void write_fen(const Position& position, std::string& fen)
+{
+	for (uint8_t rank = RANK_8; rank >= RANK_1; rank--)
+	{
+		char empty_squares = 0;
+
+		for (uint8_t file = FILE_A; file <= FILE_H; file++)
+		{
+			const Square square(file, rank);
+			const Piece piece = position.get_piece(square);
+
+			if (piece == Piece::Empty)
+			{
+				empty_squares++;
+				continue;
+			}
+
+			if (empty_squares > 0)
+			{
+				fen += static_cast<char>('0' + empty_squares);
+				empty_squares = 0;
+			}
+
+			const char c = convert_piece_to_char(piece);
+			fen += (position.get_color(square) == Color::White) ? static_cast<char>(c - 'a' + 'A') : c;
+		}
+
+		if (empty_squares > 0)
+		{
+			fen += static_cast<char>('0' + empty_squares);
+		}
+
+		if (rank > RANK_1)
+		{
+			fen += '/';
+		}
+	}
+
+	fen += (position.get_player() == Color::White) ? " w " : " b ";
+
+	const size_t castling_start = fen.size();
+
+	if (position.may_white_kingside_castle())
+	{
+		fen += 'K';
+	}
+	if (position.may_white_queenside_castle())
+	{
+		fen += 'Q';
+	}
+	if (position.may_black_kingside_castle())
+	{
+		fen += 'k';
+	}
+	if (position.may_black_queenside_castle())
+	{
+		fen += 'q';
+	}
+	if (fen.size() == castling_start)
+	{
+		fen += '-';
+	}
+
+	fen += " - ";
+	append_number(fen, position.get_halfmove_clock());
+	fen += ' ';
+	append_number(fen, position.get_fullmove_number());
+}
+
+std::string_view trim_spaces(std::string_view text)
+{
+	const size_t start = text.find_first_not_of(" \t");
+
+	if (start == std::string_view::npos)
+	{
+		return {};
+	}
+
+	return text.substr(start, text.find_last_not_of(" \t") - start + 1);
+}
+
+void apply_epd_opcode(std::string_view opcode, std::string_view operands, Position& position, EpdRecord& record)
+{
+	if (opcode == "id")
+	{
+		if (operands.size() >= 2 && operands.front() == '"' && operands.back() == '"')
+		{
+			operands = operands.substr(1, operands.size() - 2);
+		}
+
+		record.id = operands;
+	}
+	else if (opcode == "bm")
+	{
+		record.best_moves = operands;
+	}
+	else if (opcode == "am")
+	{
+		record.avoid_moves = operands;
+	}
+	else if (opcode == "hmvc")
+	{
+		position.set_halfmove_clock(parse_number<unsigned int>(operands));
+	}
+	else if (opcode == "fmvn")
+	{
+		position.set_fullmove_number(std::max(parse_number<unsigned int>(operands), 1u));
+	}
+	else if (opcode.size() >= 2 && opcode.front() == 'D')
+	{
+		const unsigned int depth = parse_number<unsigned int>(opcode.substr(1));
+
+		if (depth >= 1 && depth <= max_epd_perft_depth)
+		{
+			record.perft_nodes[depth] = parse_number<uint64_t>(operands);
+			record.perft_depth = std::max(record.perft_depth, depth);
+		}
+	}
+	// Other opcodes are skipped
+}
+
+bool parse_epd(std::string_view line, Position& position, EpdRecord& record)
+{
+	record = EpdRecord();
+
+	size_t i = parse_fen_fields(line, position);
+
+	if (i == fen_error)
+	{
+		return false;
+	}
+
+	// Many EPD files carry the FEN clocks as well
+	i = parse_fen_clocks(line, i, position);
+
+	if (i == fen_error)
+	{
+		return false;
+	}
+
+	while (true)
+	{
+		i = skip_spaces(line, i);
+
+		if (i >= line.size())
+		{
+			break;
+		}
+
+		if (line[i] == ';')
+		{
+			i++;
+			continue;
+		}
+
+		const size_t opcode_end = std::min(line.find_first_of(" \t;", i), line.size());
+		const std::string_view opcode = line.substr(i, opcode_end - i);
+
+		// The operands end at the first ';' outside a string
+		size_t operands_end = opcode_end;
+		bool in_string = false;
+
+		for (; operands_end < line.size() && (in_string || line[operands_end] != ';'); operands_end++)
+		{
+			if (line[operands_end] == '"')
+			{
+				in_string = !in_string;
+			}
+		}
+
+		apply_epd_opcode(opcode, trim_spaces(line.substr(opcode_end, operands_end - opcode_end)), position, record);
+
+		i = operands_end + 1;
+	}
+
+	return true;
+}
+
+PositionString::PositionString(std::string_view string)
+{
+	constexpr std::string_view fen_keyword = "fen";
+
 	if (string == "startpos")
 	{
 		m_position.setup_standard_position();
+		m_valid = true;
+		return;
+	}
+
+	if (string.starts_with(fen_keyword))
+	{
+		string.remove_prefix(fen_keyword.size());
+	}
+
+	m_valid = parse_fen(string, m_position);
+
+	if (!m_valid)
+	{
+		log_error("Invalid FEN: '%.*s'", static_cast<int>(string.size()), string.data());
 	}
-	// Parse string -> construct position
 }
 
 Position PositionString::get_position() const
 {
 	return m_position;
+}
+
+bool PositionString::is_valid() const
+{
+	return m_valid;
+}
+
+Move parse_move_string(const Position& position, std::string_view move_string)
+{
+	Move move(move_string);
+
+	// Decode move type (if not a promotion move that is encoded in the string)
+	if (move.get_type() == MoveType::Quiet)
+	{
+		const Square from_square = move.get_from_square();
+		const Square to_square = move.get_to_square();
+		const Piece piece = position.get_piece(from_square);
+		const Color to_color = position.get_color(to_square);
+		const uint8_t from_file = from_square.get_file();
+		const uint8_t to_file = to_square.get_file();
+		const uint8_t file_diff = (from_file > to_file) ? (from_file - to_file) : (to_file - from_file);
+
+		// Castling
+		if (piece == Piece::King && file_diff > 1)
+		{
+			if (from_file > to_file)
+			{
+				move.set_type(MoveType::QueenCastle);
+			}
+			if (from_file < to_file)
+			{
+				move.set_type(MoveType::KingCastle);
+			}
+		}
+
+		// En Passant
+		if (piece == Piece::Pawn && file_diff == 1 && to_color == Color::Empty)
+		{
+			move.set_type(MoveType::EnPassant);
+		}
+	}
+
+	return move;
 }
\ No newline at end of file
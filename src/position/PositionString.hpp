@@ -3,18 +3,54 @@
 
 #include "position/Position.hpp"
 
+#include <array>
+#include <cstdint>
 #include <string>
+#include <string_view>
 
+// The position part of a UCI position command: "startpos", or "fen" followed by a FEN
 class PositionString
 {
 public:
 	PositionString() = delete;
-	PositionString(const std::string& string);  // Takes a FEN string (at least that is the plan)
+	PositionString(std::string_view string);
 
 	Position get_position() const;
 
+	// False if the FEN could not be read
+	bool is_valid() const;
+
 private:
 	Position m_position;
+	bool m_valid = false;
+};
+
+// Reads a FEN into position, parsing in place without allocating. The clocks may be left out, they then start at 0 and 1.
+// Returns false if the FEN is not valid, position is undefined then.
+bool parse_fen(std::string_view fen, Position& position);
+
+// Appends the FEN of the position to fen, so a reused string allocates nothing
+void write_fen(const Position& position, std::string& fen);
+
+constexpr unsigned int max_epd_perft_depth = 15;
+
+// The opcodes of an EPD line the engine understands. The views point into the line.
+struct EpdRecord
+{
+	std::string_view id;
+	std::string_view best_moves;   // Operands of bm as written, usually in SAN
+	std::string_view avoid_moves;  // Operands of am
+
+	// Node counts of D1 to D15, indexed by depth, 0 if not given
+	std::array<uint64_t, max_epd_perft_depth + 1> perft_nodes = {};
+	unsigned int perft_depth = 0;  // Deepest depth given
 };
 
+// Reads an EPD line: the first four FEN fields, then opcodes with their operands, each ending with ';'.
+// The clocks come from the hmvc and fmvn opcodes. Returns false if the position is not valid.
+bool parse_epd(std::string_view line, Position& position, EpdRecord& record);
+
+// Construct a move from a string like "e7e8q", decoding castling and en passant from the position
+Move parse_move_string(const Position& position, std::string_view move_string);
+
 #endif  // POSITION_POSITIONSTRING_HPP
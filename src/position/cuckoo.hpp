@@ -0,0 +1,121 @@
+#ifndef POSITION_CUCKOO_HPP
+#define POSITION_CUCKOO_HPP
+
+#include "movegen/movegen_rays.hpp"
+#include "position/zobrist.hpp"
+
+#include <array>
+#include <cstdint>
+#include <utility>
+
+// Every reversible move of a non-pawn piece, found by the hash difference it makes, so the search can tell
+// that a move leads back to an earlier position without generating moves. Both directions share one entry.
+struct CuckooEntry
+{
+	uint64_t key = 0;  // Piece keys of both squares and the side to move key, zero for empty slots
+	uint8_t from_square = 0;
+	uint8_t to_square = 0;
+	Bitboard between;  // Squares that must be empty for the move, only sliders have any
+};
+
+constexpr size_t cuckoo_table_size = 8192;
+
+constexpr size_t get_cuckoo_first_index(uint64_t key)
+{
+	return key & (cuckoo_table_size - 1);
+}
+
+constexpr size_t get_cuckoo_second_index(uint64_t key)
+{
+	return (key >> 16) & (cuckoo_table_size - 1);
+}
+
+constexpr std::array<CuckooEntry, cuckoo_table_size> cuckoo_table = []()
+{
+	std::array<CuckooEntry, cuckoo_table_size> table{};
+
+	constexpr std::array<Piece, 5> pieces = {Piece::Knight, Piece::Bishop, Piece::Rook, Piece::Queen, Piece::King};
+
+	for (Color color : {Color::White, Color::Black})
+	{
+		for (Piece piece : pieces)
+		{
+			for (uint8_t from = 0; from < 64; from++)
+			{
+				for (uint8_t to = from + 1; to < 64; to++)
+				{
+					const Square from_square(from);
+					const Square to_square(to);
+
+					bool reachable = false;
+					Bitboard between;
+
+					if (piece == Piece::Knight || piece == Piece::King)
+					{
+						const Ray ray = (piece == Piece::Knight) ? Ray::Knight : Ray::King;
+						reachable = movegen_rays[static_cast<uint8_t>(ray)][from].read_by_square(to_square);
+					}
+					else
+					{
+						// The eight slider rays alternate diagonal and orthogonal, starting with NE
+						for (uint8_t ray = 0; ray < 8; ray++)
+						{
+							const bool diagonal = (ray % 2 == 0);
+
+							if ((diagonal && piece == Piece::Rook) || (!diagonal && piece == Piece::Bishop))
+							{
+								continue;
+							}
+
+							if (movegen_rays[ray][from].read_by_square(to_square))
+							{
+								reachable = true;
+								between = movegen_rays[ray][from] & movegen_rays[(ray + 4) % 8][to];
+							}
+						}
+					}
+
+					if (!reachable)
+					{
+						continue;
+					}
+
+					CuckooEntry entry{get_zobrist_piece_key(color, piece, from_square) ^ get_zobrist_piece_key(color, piece, to_square) ^ zobrist_keys.black_to_move, from, to,
+									  between};
+
+					// Kick out whatever is in the slot and move it to its other slot, until an empty slot is found
+					size_t index = get_cuckoo_first_index(entry.key);
+					while (true)
+					{
+						std::swap(table[index], entry);
+
+						if (entry.key == 0)
+						{
+							break;
+						}
+
+						index = (index == get_cuckoo_first_index(entry.key)) ? get_cuckoo_second_index(entry.key) : get_cuckoo_first_index(entry.key);
+					}
+				}
+			}
+		}
+	}
+
+	return table;
+}();
+
+// The reversible move changing the hash by key_difference, nullptr if there is none
+constexpr const CuckooEntry* find_cuckoo_entry(uint64_t key_difference)
+{
+	if (const CuckooEntry& entry = cuckoo_table[get_cuckoo_first_index(key_difference)]; entry.key == key_difference)
+	{
+		return &entry;
+	}
+	if (const CuckooEntry& entry = cuckoo_table[get_cuckoo_second_index(key_difference)]; entry.key == key_difference)
+	{
+		return &entry;
+	}
+	return nullptr;
+}
+
+#endif  // POSITION_CUCKOO_HPP
@@ -0,0 +1,69 @@
+#ifndef POSITION_ZOBRIST_HPP
+#define POSITION_ZOBRIST_HPP
+
+#include "types/Color.hpp"
+#include "types/Piece.hpp"
+#include "types/Square.hpp"
+
+#include <array>
+#include <cstdint>
+
+struct ZobristKeys
+{
+	std::array<std::array<std::array<uint64_t, 64>, types_of_pieces>, 2> pieces;  // Indexed by [Color][Piece][Square]
+	std::array<uint64_t, 16> castling;                                            // Indexed by the castling rights bitmask
+	uint64_t black_to_move;
+};
+
+constexpr ZobristKeys zobrist_keys = []()
+{
+	ZobristKeys keys{};
+
+	// splitmix64, fixed seed so hashes are reproducible between runs
+	uint64_t state = 0x7468696e6b65727aULL;
+
+	auto next_random = [&state]()
+	{
+		state += 0x9e3779b97f4a7c15ULL;
+		uint64_t z = state;
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		return z ^ (z >> 31);
+	};
+
+	for (auto& color_keys : keys.pieces)
+	{
+		for (auto& piece_keys : color_keys)
+		{
+			for (uint64_t& key : piece_keys)
+			{
+				key = next_random();
+			}
+		}
+	}
+
+	// Each castling right gets a random key, combinations are the XOR of their parts
+	std::array<uint64_t, 4> castling_right_keys = {next_random(), next_random(), next_random(), next_random()};
+
+	for (uint8_t rights = 0; rights < keys.castling.size(); rights++)
+	{
+		for (uint8_t bit = 0; bit < castling_right_keys.size(); bit++)
+		{
+			if (rights & (1 << bit))
+			{
+				keys.castling[rights] ^= castling_right_keys[bit];
+			}
+		}
+	}
+
+	keys.black_to_move = next_random();
+
+	return keys;
+}();
+
+constexpr uint64_t get_zobrist_piece_key(Color color, Piece piece, Square square)
+{
+	return zobrist_keys.pieces[static_cast<uint8_t>(color)][static_cast<uint8_t>(piece)][square.get_data()];
+}
+
+#endif  // POSITION_ZOBRIST_HPP
@@ -0,0 +1,227 @@
+#ifndef SEARCH_HISTORY_HPP
+#define SEARCH_HISTORY_HPP
+
+#include "types/Color.hpp"
+#include "types/Move.hpp"
+#include "types/Piece.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+constexpr int max_history = 16384;
+
+// Gravity update: the entry moves towards +-max_history, bigger entries move slower. This keeps it bounded and lets old information fade out.
+inline void apply_history_bonus(int16_t& entry, int bonus)
+{
+	bonus = std::clamp(bonus, -max_history, max_history);
+	entry += bonus - entry * std::abs(bonus) / max_history;
+}
+
+// Bonus for a quiet move causing a beta cutoff at the given remaining depth
+inline int history_bonus(unsigned int depth)
+{
+	return std::min(static_cast<int>(depth * depth) * 16, max_history / 8);
+}
+
+// Quiet move history indexed by [Color][from][to]
+class ButterflyHistory
+{
+public:
+	ButterflyHistory()
+	{
+		clear();
+	}
+
+	void clear()
+	{
+		for (auto& color_table : m_table)
+		{
+			for (auto& from_table : color_table)
+			{
+				from_table.fill(0);
+			}
+		}
+	}
+
+	// Halve all entries, called between searches so the previous move still guides ordering without dominating it
+	void age()
+	{
+		for (auto& color_table : m_table)
+		{
+			for (auto& from_table : color_table)
+			{
+				for (int16_t& entry : from_table)
+				{
+					entry /= 2;
+				}
+			}
+		}
+	}
+
+	int get(Color color, const Move& move) const
+	{
+		return m_table[static_cast<uint8_t>(color)][move.get_from_square().get_data()][move.get_to_square().get_data()];
+	}
+
+	void update(Color color, const Move& move, int bonus)
+	{
+		apply_history_bonus(m_table[static_cast<uint8_t>(color)][move.get_from_square().get_data()][move.get_to_square().get_data()], bonus);
+	}
+
+private:
+	std::array<std::array<std::array<int16_t, 64>, 64>, 2> m_table;
+};
+
+// Pieces including their color, used by the move-pair tables
+constexpr size_t colored_piece_count = 2 * types_of_pieces;
+
+inline size_t get_colored_piece_index(Color color, Piece piece)
+{
+	return static_cast<uint8_t>(color) * types_of_pieces + static_cast<uint8_t>(piece);
+}
+
+// History of a move given by the moving piece and its to square
+class PieceToHistory
+{
+public:
+	int get(size_t piece_index, Square to_square) const
+	{
+		return m_table[piece_index][to_square.get_data()];
+	}
+
+	void update(size_t piece_index, Square to_square, int bonus)
+	{
+		apply_history_bonus(m_table[piece_index][to_square.get_data()], bonus);
+	}
+
+	void fill(int16_t value)
+	{
+		for (auto& piece_table : m_table)
+		{
+			piece_table.fill(value);
+		}
+	}
+
+	void age()
+	{
+		for (auto& piece_table : m_table)
+		{
+			for (int16_t& entry : piece_table)
+			{
+				entry /= 2;
+			}
+		}
+	}
+
+private:
+	std::array<std::array<int16_t, 64>, colored_piece_count> m_table;
+};
+
+// Continuation history indexed by [previous piece][previous to][piece][to]. The previous move selects one contiguous PieceToHistory (1.5 kB),
+// so all quiet moves at a node are scored from the same few cache lines.
+class ContinuationHistory
+{
+public:
+	ContinuationHistory() : m_tables(colored_piece_count * 64)  // On the heap, the full table is over a megabyte
+	{
+		clear();
+	}
+
+	void clear()
+	{
+		for (PieceToHistory& table : m_tables)
+		{
+			table.fill(0);
+		}
+	}
+
+	void age()
+	{
+		for (PieceToHistory& table : m_tables)
+		{
+			table.age();
+		}
+	}
+
+	PieceToHistory& get(size_t previous_piece_index, Square previous_to_square)
+	{
+		return m_tables[previous_piece_index * 64 + previous_to_square.get_data()];
+	}
+
+private:
+	std::vector<PieceToHistory> m_tables;
+};
+
+// The quiet move which last refuted a given previous move, indexed by [previous piece][previous to]
+class CounterMoves
+{
+public:
+	void clear()
+	{
+		for (auto& piece_table : m_table)
+		{
+			piece_table.fill(Move());
+		}
+	}
+
+	Move get(size_t previous_piece_index, Square previous_to_square) const
+	{
+		return m_table[previous_piece_index][previous_to_square.get_data()];
+	}
+
+	void set(size_t previous_piece_index, Square previous_to_square, const Move& move)
+	{
+		m_table[previous_piece_index][previous_to_square.get_data()] = move;
+	}
+
+private:
+	std::array<std::array<Move, 64>, colored_piece_count> m_table;
+};
+
+// The quiet move tables relevant at one node, combined into a single score for ordering and reductions
+class QuietHistory
+{
+public:
+	QuietHistory(const ButterflyHistory& butterfly, const PieceToHistory* one_ply, const PieceToHistory* two_ply)
+		: m_butterfly(butterfly), m_continuations({one_ply, two_ply})
+	{
+	}
+
+	int get(Color player, Piece piece, const Move& move) const
+	{
+		int score = m_butterfly.get(player, move);
+
+		const size_t piece_index = get_colored_piece_index(player, piece);
+
+		for (const PieceToHistory* continuation : m_continuations)
+		{
+			if (continuation != nullptr)
+			{
+				score += continuation->get(piece_index, move.get_to_square());
+			}
+		}
+
+		return score;
+	}
+
+private:
+	const ButterflyHistory& m_butterfly;
+	std::array<const PieceToHistory*, 2> m_continuations;  // One and two plies back, nullptr if there is no such move
+};
+
+// Two quiet moves per ply that caused a beta cutoff in a sibling node
+using KillerMoves = std::array<Move, 2>;
+
+inline void store_killer(KillerMoves& killers, const Move& move)
+{
+	if (killers[0] != move)
+	{
+		killers[1] = killers[0];
+		killers[0] = move;
+	}
+}
+
+#endif  // SEARCH_HISTORY_HPP
@@ -0,0 +1,564 @@
+#include "MonteCarloTreeSearch.hpp"
+
+#include "console/uci_output.hpp"
+#include "evaluation/evaluation.hpp"
+#include "position/PositionAnalysis.hpp"
+#include "search/MovePicker.hpp"
+#include "search/see.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+constexpr uint32_t node_capacity = 1u << 21;  // 64 MB of nodes
+
+// The subtree of the new root is only kept while the pool has room left, otherwise the tree starts over
+constexpr uint32_t node_reuse_limit = node_capacity / 4 * 3;
+
+// Exploration constant of PUCT. Higher values trust the priors longer before the values take over.
+constexpr float puct_constant = 1.5f;
+
+// Unvisited children are assumed to be worse than their parent, by more the more of the prior has been tried already
+constexpr float first_play_urgency_reduction = 0.3f;
+
+// Values are tanh(centipawns / scale), and reported back as centipawns the same way
+constexpr double value_scale_centipawns = 400.0;
+
+constexpr double value_fixed_point = 65536.0;  // Node value sums are integers, for atomic adds
+
+// The main thread checks the clock after every playout, as a playout ends in a quiescence search and takes long enough.
+// The node count is added up, and the other limits checked, every this many playouts. UCI info goes out at most this often.
+constexpr uint64_t limit_poll_interval = 256;
+constexpr int64_t report_interval_ms = 1000;
+
+MonteCarloTreeSearch::MonteCarloTreeSearch(EVALUATION_TYPE evaluation_type) : m_evaluation_type(evaluation_type)
+{
+}
+
+void MonteCarloTreeSearch::set_stop_signal(std::atomic<bool>* stop_signal)
+{
+	m_stop_signal = stop_signal;
+}
+
+void MonteCarloTreeSearch::set_time_manager(TimeManager* time_manager)
+{
+	m_time_manager = time_manager;
+}
+
+void MonteCarloTreeSearch::set_node_counter(std::atomic<uint64_t>* node_counter)
+{
+	m_node_counter = node_counter;
+}
+
+void MonteCarloTreeSearch::set_policy(PolicyFunction policy)
+{
+	m_policy = policy;
+}
+
+void MonteCarloTreeSearch::clear()
+{
+	m_root = no_node;
+}
+
+Move MonteCarloTreeSearch::search_for_best_move(const Position& position, std::span<const uint64_t> key_history, const MoveList& legal_moves, const SearchLimits& limits,
+												size_t thread_count)
+{
+	if (legal_moves.empty())
+	{
+		return Move("0000");
+	}
+
+	if (!m_nodes)
+	{
+		m_nodes = std::make_unique<Node[]>(node_capacity);
+	}
+
+	thread_count = std::max<size_t>(thread_count, 1);
+
+	while (m_workers.size() < thread_count)
+	{
+		auto worker = std::make_unique<Worker>();
+		worker->moves.reserve(max_moves);
+
+		for (MoveList& captures : worker->capture_buffers)
+		{
+			captures.reserve(max_moves);
+		}
+
+		m_workers.push_back(std::move(worker));
+	}
+
+	for (size_t i = 0; i < thread_count; i++)
+	{
+		Worker& worker = *m_workers[i];
+		worker.keys.assign(key_history.begin(), key_history.end());
+		worker.keys.push_back(position.get_hash());
+		worker.root_key_count = worker.keys.size();
+		worker.playouts = 0;
+		worker.reported_playouts = 0;
+		worker.selective_depth = 0;
+	}
+
+	find_root(position, legal_moves);
+
+	Node& root = m_nodes[m_root];
+	if (root.state.load(std::memory_order_relaxed) == NodeState::Unexpanded)
+	{
+		root.state.store(NodeState::Expanding, std::memory_order_relaxed);
+
+		if (!expand(root, position, legal_moves, *m_workers.front()))
+		{
+			return legal_moves.front();
+		}
+	}
+
+	m_last_report_ms = 0;
+
+	std::vector<std::thread> helpers;
+
+	for (size_t i = 1; i < thread_count; i++)
+	{
+		helpers.emplace_back([this, i, &position, &limits]() { run_worker(*m_workers[i], i, position, limits); });
+	}
+
+	run_worker(*m_workers.front(), 0, position, limits);
+
+	m_stop_signal->store(true, std::memory_order_relaxed);
+
+	for (std::thread& helper : helpers)
+	{
+		helper.join();
+	}
+
+	report(*m_workers.front());
+
+	const Node* best_child = get_best_child(root);
+
+	return (best_child != nullptr) ? best_child->move : legal_moves.front();
+}
+
+void MonteCarloTreeSearch::run_worker(Worker& worker, size_t thread_index, const Position& root_position, const SearchLimits& limits)
+{
+	while (!m_stop_signal->load(std::memory_order_relaxed))
+	{
+		playout(worker, root_position);
+		worker.playouts++;
+
+		if (thread_index == 0 && time_limit_reached())
+		{
+			m_stop_signal->store(true, std::memory_order_relaxed);
+		}
+
+		if (worker.playouts % limit_poll_interval == 0)
+		{
+			m_node_counter->fetch_add(worker.playouts - worker.reported_playouts, std::memory_order_relaxed);
+			worker.reported_playouts = worker.playouts;
+
+			if (thread_index == 0)
+			{
+				poll_limits(worker, limits);
+			}
+		}
+	}
+
+	m_node_counter->fetch_add(worker.playouts - worker.reported_playouts, std::memory_order_relaxed);
+	worker.reported_playouts = worker.playouts;
+}
+
+void MonteCarloTreeSearch::playout(Worker& worker, const Position& root_position)
+{
+	Position position = root_position;
+	worker.keys.resize(worker.root_key_count);
+
+	// Selection. Every node on the path gets a virtual loss until its real result is backed up.
+	Node* node = &m_nodes[m_root];
+	unsigned int ply = 0;
+
+	while (true)
+	{
+		node->virtual_loss.fetch_add(1, std::memory_order_relaxed);
+		worker.path[ply] = node;
+
+		if (ply == max_search_ply || node->state.load(std::memory_order_acquire) != NodeState::Expanded)
+		{
+			break;
+		}
+
+		node = select_child(*node);
+		position.make_move(node->move);
+		worker.keys.push_back(position.get_hash());
+		ply++;
+	}
+
+	worker.selective_depth = std::max(worker.selective_depth, ply);
+
+	// Expansion and evaluation, value is for the player to move at the leaf
+	float value = 0.0f;
+	NodeState state = node->state.load(std::memory_order_acquire);
+
+	const bool draw = (ply > 0 && (position.get_halfmove_clock() >= 100 || is_repetition(worker, position)));
+
+	if (state == NodeState::Unexpanded && !draw && ply < max_search_ply && node->state.compare_exchange_strong(state, NodeState::Expanding, std::memory_order_acq_rel))
+	{
+		generate_legal_moves(position, worker.moves);
+
+		if (worker.moves.empty())
+		{
+			node->state.store(NodeState::Terminal, std::memory_order_release);
+			state = NodeState::Terminal;
+		}
+		else
+		{
+			expand(*node, position, worker.moves, worker);
+		}
+	}
+
+	if (state == NodeState::Terminal)
+	{
+		value = PositionAnalysis(position).player_in_check() ? -1.0f : 0.0f;
+	}
+	else if (!draw)
+	{
+		value = evaluate_leaf(position, worker);
+	}
+
+	// Backup. A node holds its value from the view of the player who moved into it, the opponent of the player to move there.
+	for (unsigned int i = ply + 1; i-- > 0;)
+	{
+		value = -value;
+
+		Node& path_node = *worker.path[i];
+		path_node.value_sum.fetch_add(static_cast<int64_t>(value * value_fixed_point), std::memory_order_relaxed);
+		path_node.visits.fetch_add(1, std::memory_order_relaxed);
+		path_node.virtual_loss.fetch_sub(1, std::memory_order_relaxed);
+	}
+}
+
+MonteCarloTreeSearch::Node* MonteCarloTreeSearch::select_child(Node& node) const
+{
+	const uint32_t parent_visits = node.visits.load(std::memory_order_relaxed) + node.virtual_loss.load(std::memory_order_relaxed);
+	const float exploration = puct_constant * std::sqrt(static_cast<float>(std::max<uint32_t>(parent_visits, 1)));
+
+	float visited_prior = 0.0f;
+
+	for (uint32_t i = 0; i < node.child_count; i++)
+	{
+		const Node& child = m_nodes[node.first_child + i];
+
+		if (child.visits.load(std::memory_order_relaxed) + child.virtual_loss.load(std::memory_order_relaxed) > 0)
+		{
+			visited_prior += child.prior;
+		}
+	}
+
+	// The value of the node is from the view of the opponent of the player choosing here
+	const float first_play_urgency = (node.visits.load(std::memory_order_relaxed) > 0) ? -get_q(node) - first_play_urgency_reduction * std::sqrt(visited_prior) : 0.0f;
+
+	Node* best_child = nullptr;
+	float best_score = std::numeric_limits<float>::lowest();
+
+	for (uint32_t i = 0; i < node.child_count; i++)
+	{
+		Node& child = m_nodes[node.first_child + i];
+
+		const uint32_t visits = child.visits.load(std::memory_order_relaxed);
+		const uint32_t virtual_loss = child.virtual_loss.load(std::memory_order_relaxed);
+		const uint32_t effective_visits = visits + virtual_loss;
+
+		// Every virtual loss counts as a lost playout
+		const float q = (effective_visits == 0) ? first_play_urgency
+												: static_cast<float>((child.value_sum.load(std::memory_order_relaxed) / value_fixed_point - virtual_loss) / effective_visits);
+
+		const float score = q + exploration * child.prior / (1 + effective_visits);
+
+		if (score > best_score)
+		{
+			best_score = score;
+			best_child = &child;
+		}
+	}
+
+	return best_child;
+}
+
+bool MonteCarloTreeSearch::expand(Node& node, const Position& position, const MoveList& legal_moves, Worker& worker)
+{
+	const uint32_t first_child = allocate_nodes(static_cast<uint32_t>(legal_moves.size()));
+
+	// Out of nodes, the node stays a leaf
+	if (first_child == no_node)
+	{
+		node.state.store(NodeState::Unexpanded, std::memory_order_release);
+		return false;
+	}
+
+	m_policy(position, legal_moves, std::span<float>(worker.priors.data(), legal_moves.size()));
+
+	for (size_t i = 0; i < legal_moves.size(); i++)
+	{
+		reset_node(m_nodes[first_child + i], legal_moves[i], worker.priors[i]);
+	}
+
+	node.first_child = first_child;
+	node.child_count = static_cast<uint16_t>(legal_moves.size());
+	node.state.store(NodeState::Expanded, std::memory_order_release);
+
+	return true;
+}
+
+float MonteCarloTreeSearch::evaluate_leaf(const Position& position, Worker& worker)
+{
+	const int score = quiescence(position, -infinite_score, infinite_score, 0, worker);
+
+	return static_cast<float>(std::tanh(score / value_scale_centipawns));
+}
+
+int MonteCarloTreeSearch::quiescence(const Position& position, int alpha, int beta, unsigned int depth, Worker& worker)
+{
+	const int stand_pat = evaluate_board(position, m_evaluation_type);
+
+	if (stand_pat >= beta || depth == quiescence_max_depth)
+	{
+		return stand_pat;
+	}
+
+	alpha = std::max(alpha, stand_pat);
+
+	MoveList& captures = worker.capture_buffers[depth];
+	generate_legal_captures(position, captures);
+
+	MovePicker move_picker(position, captures, Move());
+
+	Move move;
+	while (move_picker.next(move))
+	{
+		// Only exchanges that do not lose material, the point is to settle hanging pieces quickly
+		if (!see(position, move, 0))
+		{
+			continue;
+		}
+
+		Position child = position;
+		child.make_move(move);
+
+		const int score = -quiescence(child, -beta, -alpha, depth + 1, worker);
+
+		if (score >= beta)
+		{
+			return score;
+		}
+
+		alpha = std::max(alpha, score);
+	}
+
+	return alpha;
+}
+
+bool MonteCarloTreeSearch::is_repetition(const Worker& worker, const Position& position) const
+{
+	// The current position is the last key. A repetition anywhere in the game counts, as in the search tree of alpha-beta.
+	const size_t index = worker.keys.size() - 1;
+	const size_t max_distance = std::min<size_t>(std::min(position.get_halfmove_clock(), position.get_plies_from_null()), index);
+
+	for (size_t distance = 4; distance <= max_distance; distance += 2)
+	{
+		if (worker.keys[index - distance] == worker.keys[index])
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+uint32_t MonteCarloTreeSearch::allocate_nodes(uint32_t count)
+{
+	uint32_t first = m_node_count.load(std::memory_order_relaxed);
+
+	do
+	{
+		if (first + count > node_capacity)
+		{
+			return no_node;
+		}
+	} while (!m_node_count.compare_exchange_weak(first, first + count, std::memory_order_relaxed));
+
+	return first;
+}
+
+void MonteCarloTreeSearch::reset_node(Node& node, const Move& move, float prior)
+{
+	node.move = move;
+	node.prior = prior;
+	node.visits.store(0, std::memory_order_relaxed);
+	node.virtual_loss.store(0, std::memory_order_relaxed);
+	node.value_sum.store(0, std::memory_order_relaxed);
+	node.first_child = no_node;
+	node.child_count = 0;
+	node.state.store(NodeState::Unexpanded, std::memory_order_relaxed);
+}
+
+void MonteCarloTreeSearch::find_root(const Position& position, const MoveList& legal_moves)
+{
+	const uint64_t hash = position.get_hash();
+
+	// With searchmoves the root has fewer children than the tree, so it is built again
+	const bool reusable = m_root != no_node && m_node_count.load(std::memory_order_relaxed) < node_reuse_limit && legal_moves.size() == generate_legal_moves(position).size();
+
+	if (reusable)
+	{
+		if (m_root_position.get_hash() == hash)
+		{
+			return;
+		}
+
+		// The new position is usually two plies on, after our move and the reply
+		const Node& root = m_nodes[m_root];
+
+		for (uint32_t i = 0; root.state.load(std::memory_order_relaxed) == NodeState::Expanded && i < root.child_count; i++)
+		{
+			const Node& child = m_nodes[root.first_child + i];
+
+			Position child_position = m_root_position;
+			child_position.make_move(child.move);
+
+			if (child_position.get_hash() == hash)
+			{
+				m_root = root.first_child + i;
+				m_root_position = position;
+				return;
+			}
+
+			for (uint32_t j = 0; child.state.load(std::memory_order_relaxed) == NodeState::Expanded && j < child.child_count; j++)
+			{
+				Position grandchild_position = child_position;
+				grandchild_position.make_move(m_nodes[child.first_child + j].move);
+
+				if (grandchild_position.get_hash() == hash)
+				{
+					m_root = child.first_child + j;
+					m_root_position = position;
+					return;
+				}
+			}
+		}
+	}
+
+	m_node_count.store(1, std::memory_order_relaxed);
+	m_root = 0;
+	m_root_position = position;
+	reset_node(m_nodes[m_root], Move(), 1.0f);
+}
+
+float MonteCarloTreeSearch::get_q(const Node& node) const
+{
+	const uint32_t visits = node.visits.load(std::memory_order_relaxed);
+
+	return (visits == 0) ? 0.0f : static_cast<float>(node.value_sum.load(std::memory_order_relaxed) / value_fixed_point / visits);
+}
+
+const MonteCarloTreeSearch::Node* MonteCarloTreeSearch::get_best_child(const Node& node) const
+{
+	if (node.state.load(std::memory_order_acquire) != NodeState::Expanded)
+	{
+		return nullptr;
+	}
+
+	const Node* best_child = nullptr;
+
+	for (uint32_t i = 0; i < node.child_count; i++)
+	{
+		const Node& child = m_nodes[node.first_child + i];
+		const uint32_t visits = child.visits.load(std::memory_order_relaxed);
+
+		if (visits == 0)
+		{
+			continue;
+		}
+
+		if (best_child == nullptr || visits > best_child->visits.load(std::memory_order_relaxed) ||
+			(visits == best_child->visits.load(std::memory_order_relaxed) && get_q(child) > get_q(*best_child)))
+		{
+			best_child = &child;
+		}
+	}
+
+	return best_child;
+}
+
+std::vector<Move> MonteCarloTreeSearch::get_pv() const
+{
+	std::vector<Move> pv;
+
+	const Node* node = get_best_child(m_nodes[m_root]);
+
+	while (node != nullptr && pv.size() < max_search_ply)
+	{
+		pv.push_back(node->move);
+		node = get_best_child(*node);
+	}
+
+	return pv;
+}
+
+void MonteCarloTreeSearch::report(const Worker& main_worker) const
+{
+	const std::vector<Move> pv = get_pv();
+	const Node* best_child = get_best_child(m_nodes[m_root]);
+
+	// The best child holds its value from the view of the player to move at the root
+	const double q = std::clamp(static_cast<double>((best_child != nullptr) ? get_q(*best_child) : 0.0f), -0.999, 0.999);
+	int score = std::clamp(static_cast<int>(value_scale_centipawns * std::atanh(q)), -mate_bound + 1, mate_bound - 1);
+
+	// Values do not tell mates apart, except for the one on the board after the best move
+	if (best_child != nullptr && best_child->state.load(std::memory_order_relaxed) == NodeState::Terminal && get_q(*best_child) > 0.0f)
+	{
+		score = mate_score - 1;
+	}
+
+	const int64_t elapsed = (m_time_manager != nullptr) ? m_time_manager->get_elapsed_ms() : 0;
+	const unsigned int hashfull = static_cast<unsigned int>(uint64_t{m_node_count.load(std::memory_order_relaxed)} * 1000 / node_capacity);
+
+	uci_info(1, static_cast<unsigned int>(pv.size()), main_worker.selective_depth, score, m_node_counter->load(std::memory_order_relaxed), elapsed, hashfull, pv);
+}
+
+bool MonteCarloTreeSearch::time_limit_reached() const
+{
+	// There is no iteration to finish, so the soft limit is a hard one
+	return m_time_manager != nullptr && (m_time_manager->hard_limit_reached() || m_time_manager->soft_limit_reached());
+}
+
+void MonteCarloTreeSearch::poll_limits(Worker& worker, const SearchLimits& limits)
+{
+	bool stop = false;
+
+	if (limits.nodes != 0 && m_node_counter->load(std::memory_order_relaxed) >= limits.nodes)
+	{
+		stop = true;
+	}
+
+	// Without room for another expansion the tree cannot grow
+	if (m_node_count.load(std::memory_order_relaxed) + max_moves > node_capacity)
+	{
+		stop = true;
+	}
+
+	// The depth limit bounds the length of the main line
+	if (limits.depth != 0 && get_pv().size() >= limits.depth)
+	{
+		stop = true;
+	}
+
+	if (stop)
+	{
+		m_stop_signal->store(true, std::memory_order_relaxed);
+	}
+
+	const int64_t elapsed = (m_time_manager != nullptr) ? m_time_manager->get_elapsed_ms() : 0;
+
+	if (elapsed >= m_last_report_ms + report_interval_ms)
+	{
+		m_last_report_ms = elapsed;
+		report(worker);
+	}
+}
@@ -0,0 +1,137 @@
+#ifndef SEARCH_MONTECARLOTREESEARCH_HPP
+#define SEARCH_MONTECARLOTREESEARCH_HPP
+
+#include "evaluation/evaluation_type.hpp"
+#include "movegen/movegen.hpp"
+#include "position/Position.hpp"
+#include "search/SearchLimits.hpp"
+#include "search/TimeManager.hpp"
+#include "search/policy.hpp"
+#include "search/score.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+// Monte Carlo tree search in the AlphaZero style. Every playout walks down the tree by PUCT, picking the child with the best
+// value plus an exploration bonus weighted by its policy prior, expands the leaf it reaches and evaluates it with a short
+// quiescence search. The value is then backed up along the path.
+//
+// Threads share one tree. A thread walking through a node adds a virtual loss to it, so the other threads spread out over
+// other nodes until the real result is backed up. Node statistics are atomics, nodes are expanded by the thread that
+// claims them first. Nodes are allocated from a pool, and the subtree of the new position is kept between moves.
+class MonteCarloTreeSearch
+{
+public:
+	MonteCarloTreeSearch(EVALUATION_TYPE evaluation_type);
+
+	void set_stop_signal(std::atomic<bool>* stop_signal);
+	void set_time_manager(TimeManager* time_manager);
+
+	// Playouts of all threads are added up here, for the node limit and the info output
+	void set_node_counter(std::atomic<uint64_t>* node_counter);
+
+	void set_policy(PolicyFunction policy);
+
+	// Forget the tree, for a new game
+	void clear();
+
+	// Runs playouts on thread_count threads until a limit is reached. Returns the most visited root move.
+	Move search_for_best_move(const Position& position, std::span<const uint64_t> key_history, const MoveList& legal_moves, const SearchLimits& limits, size_t thread_count);
+
+private:
+	static constexpr uint32_t no_node = UINT32_MAX;
+
+	// Leaves are evaluated by a quiescence search this many plies deep at most
+	static constexpr unsigned int quiescence_max_depth = 6;
+
+	enum class NodeState : uint8_t
+	{
+		Unexpanded,
+		Expanding,  // Claimed by a thread, other threads evaluate it as a leaf meanwhile
+		Expanded,
+		Terminal  // No legal moves
+	};
+
+	struct Node
+	{
+		Move move;  // The move leading here
+		float prior = 0.0f;
+
+		std::atomic<uint32_t> visits = 0;
+		std::atomic<uint32_t> virtual_loss = 0;
+		std::atomic<int64_t> value_sum = 0;  // Fixed point, from the view of the player who played move
+
+		uint32_t first_child = no_node;  // Children are allocated next to each other
+		uint16_t child_count = 0;
+		std::atomic<NodeState> state = NodeState::Unexpanded;
+	};
+
+	// Per-thread state, allocated once per search
+	struct Worker
+	{
+		std::array<Node*, max_search_ply + 1> path;
+		std::vector<uint64_t> keys;  // Game history and the root, then the positions of the current playout
+		size_t root_key_count = 0;
+		MoveList moves;
+		std::array<MoveList, quiescence_max_depth + 1> capture_buffers;
+		std::array<float, max_moves> priors;
+		uint64_t playouts = 0;
+		uint64_t reported_playouts = 0;
+		unsigned int selective_depth = 0;
+	};
+
+	void run_worker(Worker& worker, size_t thread_index, const Position& root_position, const SearchLimits& limits);
+
+	// One walk from the root to a leaf and back
+	void playout(Worker& worker, const Position& root_position);
+
+	Node* select_child(Node& node) const;
+
+	// Creates the children of the node. Returns false if there were no legal moves or the pool is full.
+	bool expand(Node& node, const Position& position, const MoveList& legal_moves, Worker& worker);
+
+	// Value of the position for the player to move, in [-1, 1]
+	float evaluate_leaf(const Position& position, Worker& worker);
+
+	int quiescence(const Position& position, int alpha, int beta, unsigned int depth, Worker& worker);
+
+	bool is_repetition(const Worker& worker, const Position& position) const;
+
+	// Claims count nodes from the pool, no_node if it is full
+	uint32_t allocate_nodes(uint32_t count);
+	void reset_node(Node& node, const Move& move, float prior);
+
+	// Keeps the subtree of the new root if it is in the tree
+	void find_root(const Position& position, const MoveList& legal_moves);
+
+	float get_q(const Node& node) const;  // Average value, without virtual loss
+
+	// Most visited children from the root down
+	std::vector<Move> get_pv() const;
+	const Node* get_best_child(const Node& node) const;
+
+	void report(const Worker& main_worker) const;
+	bool time_limit_reached() const;
+	void poll_limits(Worker& worker, const SearchLimits& limits);
+
+	EVALUATION_TYPE m_evaluation_type;
+	PolicyFunction m_policy = heuristic_policy;
+
+	std::unique_ptr<Node[]> m_nodes;  // Allocated on the first search
+	std::atomic<uint32_t> m_node_count = 0;
+	uint32_t m_root = no_node;
+	Position m_root_position;
+
+	std::vector<std::unique_ptr<Worker>> m_workers;
+
+	std::atomic<bool>* m_stop_signal = nullptr;
+	TimeManager* m_time_manager = nullptr;
+	std::atomic<uint64_t>* m_node_counter = nullptr;
+	int64_t m_last_report_ms = 0;
+};
+
+#endif  // SEARCH_MONTECARLOTREESEARCH_HPP
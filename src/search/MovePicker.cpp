@@ -0,0 +1,126 @@
+#include "MovePicker.hpp"
+
+#include "search/see.hpp"
+#include "types/conversions.hpp"
+
+#include <utility>
+
+constexpr int hash_move_score = 2000000;
+constexpr int capture_score = 1000000;
+constexpr int first_killer_score = 900000;
+constexpr int second_killer_score = 800000;
+constexpr int counter_move_score = 700000;
+constexpr int losing_capture_score = -500000;
+constexpr int underpromotion_score = -1000000;
+
+MovePicker::MovePicker(const Position& position, const MoveList& moves, const Move& hash_move, const KillerMoves& killers, const Move& counter_move, const QuietHistory& history)
+{
+	const Color player = position.get_player();
+
+	for (const Move& move : moves)
+	{
+		int score = 0;
+		const MoveType type = move.get_type();
+		const bool underpromotion = (type == MoveType::KnightPromo || type == MoveType::BishopPromo || type == MoveType::RookPromo);
+
+		if (move == hash_move)
+		{
+			score = hash_move_score;
+		}
+		else if (position.is_capture(move) || type == MoveType::QueenPromo)
+		{
+			score = (see(position, move, 0) ? capture_score : losing_capture_score) + mvv_lva(position, move);
+		}
+		else if (underpromotion)
+		{
+			score = underpromotion_score;
+		}
+		else if (move == killers[0])
+		{
+			score = first_killer_score;
+		}
+		else if (move == killers[1])
+		{
+			score = second_killer_score;
+		}
+		else if (move == counter_move)
+		{
+			score = counter_move_score;
+		}
+		else
+		{
+			score = history.get(player, position.get_piece(move.get_from_square()), move);
+		}
+
+		m_moves[m_size++] = {move, score};
+	}
+}
+
+MovePicker::MovePicker(const Position& position, const MoveList& captures, const Move& hash_move)
+{
+	for (const Move& move : captures)
+	{
+		const MoveType type = move.get_type();
+		const bool underpromotion = (type == MoveType::KnightPromo || type == MoveType::BishopPromo || type == MoveType::RookPromo);
+
+		int score = mvv_lva(position, move);
+
+		if (move == hash_move)
+		{
+			score = hash_move_score;
+		}
+		else if (underpromotion)
+		{
+			score += underpromotion_score;
+		}
+
+		m_moves[m_size++] = {move, score};
+	}
+}
+
+bool MovePicker::next(Move& move)
+{
+	if (m_current == m_size)
+	{
+		return false;
+	}
+
+	size_t best = m_current;
+
+	for (size_t i = m_current + 1; i < m_size; i++)
+	{
+		if (m_moves[i].score > m_moves[best].score)
+		{
+			best = i;
+		}
+	}
+
+	std::swap(m_moves[m_current], m_moves[best]);
+	move = m_moves[m_current++].move;
+
+	return true;
+}
+
+int MovePicker::mvv_lva(const Position& position, const Move& move)
+{
+	// Most valuable victim first, then least valuable attacker. Piece enum is ordered by value.
+	Piece victim = position.get_piece(move.get_to_square());
+
+	if (move.get_type() == MoveType::EnPassant)
+	{
+		victim = Piece::Pawn;
+	}
+
+	int score = (victim == Piece::Empty) ? 0 : (static_cast<int>(victim) + 1) * 8;
+
+	// Promotions gain the promoted piece
+	const Piece promotion = convert_promo_to_piece(move.get_type());
+	if (promotion != Piece::Empty)
+	{
+		score += static_cast<int>(promotion) * 8;
+	}
+
+	const Piece attacker = position.get_piece(move.get_from_square());
+
+	return score - static_cast<int>(attacker);
+}
@@ -0,0 +1,38 @@
+#ifndef SEARCH_MOVEPICKER_HPP
+#define SEARCH_MOVEPICKER_HPP
+
+#include "movegen/movegen.hpp"
+#include "position/Position.hpp"
+#include "search/History.hpp"
+
+#include <array>
+
+// Scores the moves of a node once and hands them out best first. Selection is lazy, since most cut nodes only look at a few moves.
+// Order: hash move, winning captures by MVV-LVA, killers, countermove, quiet moves by history, losing captures, underpromotions.
+class MovePicker
+{
+public:
+	MovePicker() = delete;
+	MovePicker(const Position& position, const MoveList& moves, const Move& hash_move, const KillerMoves& killers, const Move& counter_move, const QuietHistory& history);
+
+	// Quiescence search, only captures and promotions
+	MovePicker(const Position& position, const MoveList& captures, const Move& hash_move);
+
+	// Returns false when all moves have been picked
+	bool next(Move& move);
+
+	static int mvv_lva(const Position& position, const Move& move);
+
+private:
+	struct ScoredMove
+	{
+		Move move;
+		int score;
+	};
+
+	std::array<ScoredMove, max_moves> m_moves;
+	size_t m_size = 0;
+	size_t m_current = 0;
+};
+
+#endif  // SEARCH_MOVEPICKER_HPP
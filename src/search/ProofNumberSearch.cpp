@@ -0,0 +1,331 @@
+#include "ProofNumberSearch.hpp"
+
+#include "console/uci_output.hpp"
+#include "position/PositionAnalysis.hpp"
+#include "search/score.hpp"
+
+#include <algorithm>
+
+// Proven or disproven. Sums are capped here, so they never overflow.
+constexpr uint32_t infinite_proof = 1u << 30;
+
+constexpr size_t proof_table_size = size_t{1} << 20;  // Entries, a power of two. 16 MB.
+
+// Every this many nodes the stop signal, the clock and the node limit are checked
+constexpr uint64_t proof_poll_interval = 1024;
+
+// Part of the time and node limits the proof may use. Alpha-beta gets the rest, so there is a move when no mate is proven.
+constexpr double proof_limit_share = 0.5;
+
+ProofNumberSearch::ProofNumberSearch() : m_children(max_search_ply)
+{
+	for (std::vector<Child>& children : m_children)
+	{
+		children.reserve(max_moves);
+	}
+	m_moves.reserve(max_moves);
+}
+
+void ProofNumberSearch::set_stop_signal(std::atomic<bool>* stop_signal)
+{
+	m_stop_signal = stop_signal;
+}
+
+void ProofNumberSearch::set_time_manager(TimeManager* time_manager)
+{
+	m_time_manager = time_manager;
+}
+
+void ProofNumberSearch::set_node_counter(std::atomic<uint64_t>* node_counter)
+{
+	m_node_counter = node_counter;
+}
+
+Move ProofNumberSearch::search_for_mate(const Position& position, const SearchLimits& limits)
+{
+	if (m_table.empty())
+	{
+		m_table.resize(proof_table_size);
+	}
+
+	m_stopped = false;
+	m_node_limit = limits.nodes;
+	m_nodes = 0;
+	m_reported_nodes = 0;
+	m_selective_depth = 0;
+
+	// Mate in n moves is 2n - 1 plies, which must fit in the ply-indexed buffers
+	const unsigned int max_mate = std::min(limits.mate, max_search_ply / 2);
+
+	// Short mates are proven quickly, so trying every length from one move up finds the shortest mate at little extra cost
+	for (unsigned int mate = 1; mate <= max_mate; mate++)
+	{
+		const unsigned int plies = 2 * mate - 1;
+
+		search_node(position, infinite_proof, infinite_proof, plies, 0);
+
+		if (m_stopped)
+		{
+			break;
+		}
+
+		if (probe(get_key(position.get_hash(), plies)).proof == 0)
+		{
+			report_nodes();
+
+			const std::vector<Move> pv = extract_pv(position, plies);
+			const int64_t elapsed = (m_time_manager != nullptr) ? m_time_manager->get_elapsed_ms() : 0;
+			const uint64_t nodes = (m_node_counter != nullptr) ? m_node_counter->load(std::memory_order_relaxed) : m_nodes;
+
+			uci_info(1, plies, std::max(m_selective_depth, static_cast<unsigned int>(pv.size())), mate_score - static_cast<int>(plies), nodes, elapsed, get_hashfull(), pv);
+
+			return pv.empty() ? Move() : pv.front();
+		}
+	}
+
+	report_nodes();
+
+	return Move();
+}
+
+void ProofNumberSearch::search_node(const Position& position, uint32_t proof_threshold, uint32_t disproof_threshold, unsigned int remaining, unsigned int ply)
+{
+	if (++m_nodes % proof_poll_interval == 0)
+	{
+		poll_stop_signal();
+	}
+
+	if (m_stopped)
+	{
+		return;
+	}
+
+	m_selective_depth = std::max(m_selective_depth, ply);
+
+	const uint64_t key = get_key(position.get_hash(), remaining);
+	const bool attacker = (ply % 2 == 0);
+
+	// No plies left to give mate in
+	if (attacker && remaining == 0)
+	{
+		store(key, infinite_proof, 0);
+		return;
+	}
+
+	std::vector<Child>& children = m_children[ply];
+	generate_children(position, attacker, children);
+
+	// The attacker has no checks left, or the defender, who is always in check, is mated
+	if (children.empty())
+	{
+		attacker ? store(key, infinite_proof, 0) : store(key, 0, infinite_proof);
+		return;
+	}
+
+	if (!attacker && remaining == 0)
+	{
+		store(key, infinite_proof, 0);
+		return;
+	}
+
+	while (true)
+	{
+		// The attacker needs one proven child and the defender needs all of them, so the roles of the sums and minimums swap
+		uint32_t minimum = infinite_proof;
+		uint32_t second_minimum = infinite_proof;
+		uint32_t sum = 0;
+		uint32_t best_other = 0;
+		size_t best_index = 0;
+
+		for (size_t i = 0; i < children.size(); i++)
+		{
+			const ProofNumbers numbers = probe(get_key(children[i].hash, remaining - 1));
+			const uint32_t selecting = attacker ? numbers.proof : numbers.disproof;
+			const uint32_t summing = attacker ? numbers.disproof : numbers.proof;
+
+			if (selecting < minimum)
+			{
+				second_minimum = minimum;
+				minimum = selecting;
+				best_index = i;
+				best_other = summing;
+			}
+			else if (selecting < second_minimum)
+			{
+				second_minimum = selecting;
+			}
+
+			sum = std::min(sum + summing, infinite_proof);
+		}
+
+		const uint32_t proof = attacker ? minimum : sum;
+		const uint32_t disproof = attacker ? sum : minimum;
+
+		if (proof >= proof_threshold || disproof >= disproof_threshold)
+		{
+			store(key, proof, disproof);
+			return;
+		}
+
+		// The best child is searched until it is no longer best, or until this node reaches its own thresholds
+		const uint32_t selecting_threshold = attacker ? proof_threshold : disproof_threshold;
+		const uint32_t summing_threshold = attacker ? disproof_threshold : proof_threshold;
+
+		const uint32_t child_selecting_threshold = std::min(selecting_threshold, second_minimum + 1);
+		const uint32_t child_summing_threshold = (summing_threshold >= infinite_proof) ? infinite_proof : summing_threshold - sum + best_other;
+
+		Position child_position = position;
+		child_position.make_move(children[best_index].move);
+
+		if (attacker)
+		{
+			search_node(child_position, child_selecting_threshold, child_summing_threshold, remaining - 1, ply + 1);
+		}
+		else
+		{
+			search_node(child_position, child_summing_threshold, child_selecting_threshold, remaining - 1, ply + 1);
+		}
+
+		if (m_stopped)
+		{
+			return;
+		}
+	}
+}
+
+void ProofNumberSearch::generate_children(const Position& position, bool attacker, std::vector<Child>& children)
+{
+	children.clear();
+	generate_legal_moves(position, m_moves);
+
+	for (const Move& move : m_moves)
+	{
+		Position child_position = position;
+		child_position.make_move(move);
+
+		if (attacker && !PositionAnalysis(child_position).player_in_check())
+		{
+			continue;
+		}
+
+		children.push_back({move, child_position.get_hash()});
+	}
+}
+
+uint64_t ProofNumberSearch::get_key(uint64_t hash, unsigned int remaining)
+{
+	return hash ^ (0x9e3779b97f4a7c15ULL * (remaining + 1));
+}
+
+ProofNumberSearch::ProofNumbers ProofNumberSearch::probe(uint64_t key) const
+{
+	const Entry& entry = m_table[key & (m_table.size() - 1)];
+
+	if (entry.key == key)
+	{
+		return {entry.proof, entry.disproof};
+	}
+
+	return {};
+}
+
+void ProofNumberSearch::store(uint64_t key, uint32_t proof, uint32_t disproof)
+{
+	// Always replace. The parent reads the numbers of the child right after the child returns, so the newest entry must win.
+	m_table[key & (m_table.size() - 1)] = {key, proof, disproof};
+}
+
+void ProofNumberSearch::poll_stop_signal()
+{
+	report_nodes();
+
+	const uint64_t nodes = (m_node_counter != nullptr) ? m_node_counter->load(std::memory_order_relaxed) : m_nodes;
+
+	if ((m_time_manager != nullptr && m_time_manager->hard_limit_fraction_reached(proof_limit_share)) ||
+		(m_node_limit != 0 && nodes >= static_cast<uint64_t>(m_node_limit * proof_limit_share)))
+	{
+		m_stopped = true;
+	}
+
+	if (m_stop_signal != nullptr && m_stop_signal->load(std::memory_order_relaxed))
+	{
+		m_stopped = true;
+	}
+}
+
+void ProofNumberSearch::report_nodes()
+{
+	if (m_node_counter != nullptr)
+	{
+		m_node_counter->fetch_add(m_nodes - m_reported_nodes, std::memory_order_relaxed);
+		m_reported_nodes = m_nodes;
+	}
+}
+
+std::vector<Move> ProofNumberSearch::extract_pv(const Position& position, unsigned int remaining)
+{
+	std::vector<Move> pv;
+	Position current = position;
+
+	for (unsigned int ply = 0; ply < max_search_ply && remaining > 0; ply++, remaining--)
+	{
+		const bool attacker = (ply % 2 == 0);
+
+		std::vector<Child>& children = m_children[ply];
+		generate_children(current, attacker, children);
+
+		const Child* next = nullptr;
+		unsigned int longest_mate = 0;
+
+		for (const Child& child : children)
+		{
+			if (attacker)
+			{
+				// Any proven check will do, the shortest mate was found by trying the shorter lengths first
+				if (probe(get_key(child.hash, remaining - 1)).proof == 0)
+				{
+					next = &child;
+					break;
+				}
+				continue;
+			}
+
+			// The defender picks the reply with the longest mate the table has a proof for
+			for (unsigned int plies = (remaining - 1) % 2; plies < remaining; plies += 2)
+			{
+				if (probe(get_key(child.hash, plies)).proof == 0)
+				{
+					if (next == nullptr || plies > longest_mate)
+					{
+						next = &child;
+						longest_mate = plies;
+					}
+					break;
+				}
+			}
+		}
+
+		// Mate, or the rest of the proof was overwritten in the table
+		if (next == nullptr)
+		{
+			break;
+		}
+
+		pv.push_back(next->move);
+		current.make_move(next->move);
+
+		if (!attacker)
+		{
+			remaining = longest_mate + 1;
+		}
+	}
+
+	return pv;
+}
+
+unsigned int ProofNumberSearch::get_hashfull() const
+{
+	constexpr size_t sample_size = 1000;
+
+	return static_cast<unsigned int>(std::count_if(m_table.begin(), m_table.begin() + sample_size, [](const Entry& entry) { return entry.key != 0; }));
+}
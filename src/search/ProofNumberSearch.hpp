@@ -0,0 +1,88 @@
+#ifndef SEARCH_PROOFNUMBERSEARCH_HPP
+#define SEARCH_PROOFNUMBERSEARCH_HPP
+
+#include "movegen/movegen.hpp"
+#include "position/Position.hpp"
+#include "search/SearchLimits.hpp"
+#include "search/TimeManager.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// Depth-first proof-number search (df-pn) for "go mate N". The player to move is the attacker and only plays checks,
+// the defender plays every evasion. Each node has a proof number, the number of leaves that must still be proven to
+// prove a mate, and a disproof number for the opposite. The search always expands the most proving node, and stays
+// in a subtree until its numbers reach the thresholds given by the parent.
+class ProofNumberSearch
+{
+public:
+	ProofNumberSearch();
+
+	void set_stop_signal(std::atomic<bool>* stop_signal);
+	void set_time_manager(TimeManager* time_manager);
+
+	// Nodes searched are added here every few nodes, for the node limit and the info output
+	void set_node_counter(std::atomic<uint64_t>* node_counter);
+
+	// Proves the shortest mate within limits.mate moves. Returns the first move of the mate, reported as UCI info,
+	// or Move() when there is no such mate or the search was stopped first.
+	Move search_for_mate(const Position& position, const SearchLimits& limits);
+
+private:
+	struct Entry
+	{
+		uint64_t key = 0;
+		uint32_t proof = 0;
+		uint32_t disproof = 0;
+	};
+
+	struct Child
+	{
+		Move move;
+		uint64_t hash = 0;
+	};
+
+	struct ProofNumbers
+	{
+		uint32_t proof = 1;
+		uint32_t disproof = 1;
+	};
+
+	// Searches the node until its proof or disproof number reaches its threshold, then stores its numbers.
+	// remaining is the number of plies left for the attacker to mate in.
+	void search_node(const Position& position, uint32_t proof_threshold, uint32_t disproof_threshold, unsigned int remaining, unsigned int ply);
+
+	// Checking moves for the attacker, all moves for the defender
+	void generate_children(const Position& position, bool attacker, std::vector<Child>& children);
+
+	// The same position is a different node with a different number of plies left, so that is part of the key
+	static uint64_t get_key(uint64_t hash, unsigned int remaining);
+
+	ProofNumbers probe(uint64_t key) const;
+	void store(uint64_t key, uint32_t proof, uint32_t disproof);
+
+	void poll_stop_signal();
+	void report_nodes();
+
+	// The mate line of a proven root, with the defender resisting as long as the table shows
+	std::vector<Move> extract_pv(const Position& position, unsigned int remaining);
+
+	unsigned int get_hashfull() const;
+
+	std::vector<Entry> m_table;  // Allocated on the first mate search
+	std::vector<std::vector<Child>> m_children;  // Indexed by ply
+	MoveList m_moves;
+
+	std::atomic<bool>* m_stop_signal = nullptr;
+	bool m_stopped = false;
+	TimeManager* m_time_manager = nullptr;
+	uint64_t m_node_limit = 0;
+
+	std::atomic<uint64_t>* m_node_counter = nullptr;
+	uint64_t m_nodes = 0;
+	uint64_t m_reported_nodes = 0;
+	unsigned int m_selective_depth = 0;
+};
+
+#endif  // SEARCH_PROOFNUMBERSEARCH_HPP
@@ -1,17 +1,119 @@
 #include "Search.hpp"
 
+#include "console/uci_output.hpp"
 #include "evaluation/evaluation.hpp"
+#include "position/cuckoo.hpp"
+#include "position/PositionAnalysis.hpp"
 #include "position/PositionString.hpp"
+#include "search/MovePicker.hpp"
+#include "search/TranspositionTable.hpp"
+#include "search/score.hpp"
+#include "search/see.hpp"
+#include "types/conversions.hpp"
 
+#include <algorithm>
 #include <limits>
-#include <math.h>
+#include <span>
+#include <cmath>
 
-Search::Search() : m_evaluation_type(EVALUATION_TYPE::NONE)
+// Aspiration windows are only used once the previous iteration gives a somewhat stable score.
+constexpr unsigned int aspiration_min_depth = 3;
+constexpr int aspiration_initial_window = 25;
+// When the window grows beyond this we give up and search with a full window.
+constexpr int aspiration_max_window = 1000;
+
+// Captures that cannot bring the stand pat score within this of alpha are skipped in quiescence search
+constexpr int delta_pruning_margin = 200;
+
+// Shallow depth pruning margins, indexed by remaining depth
+// Reverse futility (static null move): the static evaluation is so far above beta that the node is assumed to fail high
+constexpr std::array<int, 7> reverse_futility_margins = {0, 100, 200, 300, 400, 500, 600};
+// Razoring: the static evaluation is so far below alpha that only captures can save the node
+constexpr std::array<int, 4> razoring_margins = {0, 250, 400, 600};
+// Futility: quiet moves which cannot raise the static evaluation above alpha at frontier and pre-frontier nodes
+constexpr std::array<int, 3> futility_margins = {0, 150, 300};
+
+// Null move pruning. The reduction grows with depth and with how far the static evaluation is above beta.
+constexpr unsigned int null_move_min_depth = 3;
+constexpr unsigned int null_move_base_reduction = 3;
+constexpr unsigned int null_move_depth_divisor = 6;
+constexpr int null_move_evaluation_divisor = 200;
+constexpr unsigned int null_move_max_evaluation_reduction = 3;
+// From this depth a null move cutoff is verified by a normal reduced search without null moves, to avoid zugzwang blunders
+constexpr unsigned int null_move_verification_depth = 8;
+
+// ProbCut: a good capture whose shallow search beats beta by the margin is assumed to beat beta at full depth
+constexpr unsigned int probcut_min_depth = 5;
+constexpr unsigned int probcut_depth_reduction = 4;
+constexpr int probcut_margin = 200;
+
+// Internal iterative reduction, nodes expected to matter that have no hash move are searched one ply shallower
+constexpr unsigned int internal_iterative_reduction_min_depth = 4;
+
+// Singular extensions: the hash move is extended if all other moves fail low against the hash score minus the margin
+constexpr unsigned int singular_extension_min_depth = 6;
+constexpr int singular_extension_margin_per_depth = 2;
+
+// The extensions along one line may add up to at most the iteration depth divided by this
+constexpr unsigned int extension_budget_divisor = 2;
+
+// ABDADA: from this depth moves after the first are searched exclusively, moves busy in another thread are put off
+constexpr unsigned int abdada_min_depth = 3;
+
+// Late move reductions, base reduction log(depth) * log(move number) / divisor
+constexpr unsigned int late_move_reduction_min_depth = 3;
+constexpr double late_move_reduction_divisor = 2.25;
+// History score worth one ply of reduction, good quiet moves are reduced less
+constexpr int late_move_reduction_history_divisor = 8192;
+
+const std::array<std::array<uint8_t, max_moves>, max_search_ply> late_move_reductions = []()
+{
+	std::array<std::array<uint8_t, max_moves>, max_search_ply> reductions{};
+
+	for (size_t depth = 1; depth < max_search_ply; depth++)
+	{
+		for (size_t move_number = 1; move_number < max_moves; move_number++)
+		{
+			reductions[depth][move_number] = static_cast<uint8_t>(std::log(depth) * std::log(move_number) / late_move_reduction_divisor);
+		}
+	}
+
+	return reductions;
+}();
+
+// Late move pruning, quiet moves after this many are skipped at shallow depth
+constexpr unsigned int late_move_pruning_max_depth = 4;
+constexpr std::array<size_t, late_move_pruning_max_depth + 1> late_move_pruning_counts = {0, 4, 7, 12, 19};
+
+// Quiet moves losing more than margin * depth^2 in exchanges on their to square are skipped at shallow depths
+constexpr unsigned int see_quiet_pruning_max_depth = 4;
+constexpr int see_quiet_pruning_margin = 30;
+
+// The shared stop signal is read every this many nodes, so a stop is answered well within a millisecond
+constexpr uint64_t stop_poll_interval = 32;
+
+// Plies without a capture or pawn move after which the game is drawn
+constexpr unsigned int fifty_move_plies = 100;
+
+// Root moves are only reported as they are searched once the search has been running this long, and not more often than the interval
+constexpr int64_t currmove_min_elapsed_ms = 1000;
+constexpr int64_t currmove_interval_ms = 250;
+
+// Lazy SMP depth staggering for helper threads, cycling through these (size, phase) pairs by thread index.
+// A helper leaves out iterations in blocks of 'size', offset by 'phase', so the threads spread over neighbouring depths.
+constexpr std::array<unsigned int, 20> helper_skip_sizes = {1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4};
+constexpr std::array<unsigned int, 20> helper_skip_phases = {0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7};
+
+Search::Search() : Search(EVALUATION_TYPE::NONE)
 {
 }
 
-Search::Search(EVALUATION_TYPE evaluation_type) : m_evaluation_type(evaluation_type)
+Search::Search(EVALUATION_TYPE evaluation_type) : m_evaluation_type(evaluation_type), m_stack(search_stack_size)
 {
+	for (SearchStackEntry& entry : m_stack)
+	{
+		entry.moves.reserve(max_moves);
+	}
 }
 
 void Search::set_evaluation_type(EVALUATION_TYPE evaluation_type)
@@ -19,106 +121,1147 @@ void Search::set_evaluation_type(EVALUATION_TYPE evaluation_type)
 	m_evaluation_type = evaluation_type;
 }
 
-std::vector<unsigned int> Search::search_for_best_move(const Position& position, const MoveList& legal_moves, const unsigned int search_depth)
+void Search::clear()
 {
-	if (m_evaluation_type == EVALUATION_TYPE::NONE)
+	m_history.clear();
+
+	for (SearchStackEntry& entry : m_stack)
 	{
-		return std::vector<unsigned int>();
+		entry.killers = KillerMoves();
 	}
 
-	std::vector<int> evaluations;
-	std::cout << "Evaluation: ";
-	for (const Move& move : legal_moves)
+	m_counter_moves.clear();
+
+	for (ContinuationHistory& continuation_history : m_continuation_history)
+	{
+		continuation_history.clear();
+	}
+}
+
+void Search::set_stop_signal(std::atomic<bool>* stop_signal)
+{
+	m_stop_signal = stop_signal;
+}
+
+void Search::set_multi_pv(unsigned int line_count)
+{
+	m_multi_pv = std::max(1u, line_count);
+}
+
+void Search::set_time_manager(TimeManager* time_manager)
+{
+	m_time_manager = time_manager;
+}
+
+void Search::set_node_counter(std::atomic<uint64_t>* node_counter)
+{
+	m_node_counter = node_counter;
+}
+
+void Search::set_thread_index(size_t thread_index)
+{
+	m_thread_index = thread_index;
+}
+
+void Search::set_parallel_search_type(ParallelSearchType parallel_search_type)
+{
+	m_parallel_search_type = parallel_search_type;
+}
+
+const SearchStatistics& Search::get_statistics() const
+{
+	return m_statistics;
+}
+
+unsigned int Search::get_completed_depth() const
+{
+	return m_completed_depth;
+}
+
+unsigned int Search::get_completed_selective_depth() const
+{
+	return m_completed_selective_depth;
+}
+
+int Search::get_best_score() const
+{
+	return m_best_score;
+}
+
+Move Search::get_best_move() const
+{
+	return m_best_move;
+}
+
+std::span<const Move> Search::get_best_pv() const
+{
+	return std::span<const Move>(m_best_pv.data(), m_best_pv_length);
+}
+
+bool Search::stop_requested() const
+{
+	return m_stopped;
+}
+
+void Search::poll_stop_signal()
+{
+	report_nodes();
+
+	if (m_stop_signal == nullptr)
+	{
+		return;
+	}
+
+	if (m_time_manager != nullptr && (m_time_manager->hard_limit_reached() || (m_node_limit != 0 && get_total_nodes() >= m_node_limit)))
+	{
+		m_stop_signal->store(true, std::memory_order_relaxed);
+	}
+
+	if (m_stop_signal->load(std::memory_order_relaxed))
 	{
-		Position temporary_position = position;
-		temporary_position.make_move(move);
-		evaluations.push_back(minimaxi(temporary_position, -std::numeric_limits<int>::max(), std::numeric_limits<int>::max(), search_depth - 1));
+		m_stopped = true;
+	}
+}
+
+void Search::report_nodes()
+{
+	if (m_node_counter != nullptr)
+	{
+		m_node_counter->fetch_add(m_statistics.nodes - m_reported_nodes, std::memory_order_relaxed);
+		m_reported_nodes = m_statistics.nodes;
+	}
+}
+
+uint64_t Search::get_total_nodes() const
+{
+	return (m_node_counter != nullptr) ? m_node_counter->load(std::memory_order_relaxed) : m_statistics.nodes;
+}
+
+void Search::report_iteration(unsigned int depth, size_t line_count)
+{
+	report_nodes();
+
+	const int64_t elapsed = (m_time_manager != nullptr) ? m_time_manager->get_elapsed_ms() : 0;
+	const uint64_t nodes = get_total_nodes();
+	const unsigned int hashfull = transposition_table.get_hashfull();
+
+	for (size_t line = 0; line < line_count; line++)
+	{
+		const RootMove& root_move = m_root_moves[line];
+
+		uci_info(line + 1, depth, m_selective_depth, root_move.score, nodes, elapsed, hashfull, std::span<const Move>(root_move.pv.data(), root_move.pv_length));
+	}
+}
 
-		std::cout << evaluations.back() << " (" << move.get_string() << ")"
-				  << " ";
+bool Search::skip_depth(unsigned int depth) const
+{
+	if (m_thread_index == 0 || m_parallel_search_type != ParallelSearchType::LazySMP)
+	{
+		return false;
 	}
-	std::cout << std::endl;
-	return find_index_with_best_evaluation(evaluations, position.get_player());
+
+	const size_t cycle_index = (m_thread_index - 1) % helper_skip_sizes.size();
+
+	return ((depth + helper_skip_phases[cycle_index]) / helper_skip_sizes[cycle_index]) % 2 != 0;
 }
 
-int Search::minimaxi(const Position& position, int alpha, int beta, unsigned int depth)
+Move Search::search_for_best_move(const Position& position, std::span<const uint64_t> key_history, const MoveList& legal_moves, const SearchLimits& limits)
 {
-	// If we are at our max search depth then evaluate position and return it.
-	if (depth == 0)
+	if (m_evaluation_type == EVALUATION_TYPE::NONE || legal_moves.empty())
+	{
+		return Move("0000");
+	}
+
+	constexpr int full_window = infinite_score;
+
+	m_root_moves.clear();
+	for (const Move& move : legal_moves)
+	{
+		m_root_moves.emplace_back().move = move;
+	}
+
+	const size_t line_count = std::min<size_t>(m_multi_pv, m_root_moves.size());
+
+	m_key_history.assign(key_history.begin(), key_history.end());
+	m_root_key_index = m_key_history.size();
+	m_key_history.resize(m_root_key_index + max_search_ply + 1);
+	m_key_history[m_root_key_index] = position.get_hash();
+
+	m_previous_pv_length = 0;
+	m_statistics = SearchStatistics();
+	m_reported_nodes = 0;
+	m_last_currmove_ms = 0;
+	m_completed_depth = 0;
+	m_completed_selective_depth = 0;
+	m_best_score = 0;
+	m_best_move = m_root_moves.front().move;
+	m_best_pv_length = 0;
+	m_history.age();
+
+	for (SearchStackEntry& entry : m_stack)
+	{
+		entry.killers = KillerMoves();
+		entry.excluded_move = Move();
+	}
+	m_stack[0].position = position;
+	m_stack[0].played_move = PlayedMove();
+
+	for (ContinuationHistory& continuation_history : m_continuation_history)
 	{
-		return evaluate_board(position, m_evaluation_type);
+		continuation_history.age();
 	}
 
-	if (position.get_player() == Color::White)  // player is white
+	m_stopped = false;
+	m_node_limit = limits.nodes;
+
+	const unsigned int search_depth = std::min<unsigned int>(limits.depth, max_search_ply - 1);
+
+	for (unsigned int depth = 1; depth <= search_depth; depth++)
 	{
-		int max_evaluation = -std::numeric_limits<int>::max();
-		const MoveList current_legal_moves = generate_legal_moves(position);
-		for (const Move& move : current_legal_moves)
+		poll_stop_signal();
+
+		if (stop_requested())
+		{
+			break;
+		}
+
+		if (skip_depth(depth))
+		{
+			continue;
+		}
+
+		m_extension_budget = std::max(1u, depth / extension_budget_divisor);
+		m_selective_depth = 0;
+
+		// With MultiPV each line is searched with the best moves of the lines before it left out.
+		// The lines share the transposition table and the move ordering tables, so the later lines are cheap.
+		for (size_t line = 0; line < line_count && !stop_requested(); line++)
 		{
-			Position temporary_position = position;
-			temporary_position.make_move(move);
-			int evaluation = minimaxi(temporary_position, alpha, beta, depth - 1);
-			max_evaluation = std::max(max_evaluation, evaluation);
-			alpha = std::max(alpha, evaluation);
-			if (beta <= alpha)
+			const RootMove& line_move = m_root_moves[line];
+
+			std::copy(line_move.pv.begin(), line_move.pv.begin() + line_move.pv_length, m_previous_pv.begin());
+			m_previous_pv_length = line_move.pv_length;
+
+			int window = aspiration_initial_window;
+			int alpha = -full_window;
+			int beta = full_window;
+
+			// A helper thread that skipped the first iterations has no score yet to put the window around
+			if (depth >= aspiration_min_depth && m_completed_depth > 0)
+			{
+				alpha = line_move.score - window;
+				beta = line_move.score + window;
+			}
+
+			while (true)
 			{
-				break;
+				const int score = search_root(line, alpha, beta, depth);
+
+				if (stop_requested() || (score > alpha && score < beta))
+				{
+					break;
+				}
+
+				window *= 2;
+
+				// Fail low, widen downwards
+				if (score <= alpha)
+				{
+					alpha = (window > aspiration_max_window) ? -full_window : std::max(-full_window, score - window);
+				}
+
+				// Fail high, widen upwards
+				if (score >= beta)
+				{
+					beta = (window > aspiration_max_window) ? full_window : std::min(full_window, score + window);
+				}
 			}
 		}
-		return max_evaluation;
+
+		if (stop_requested())
+		{
+			break;
+		}
+
+		// Search instability can make a later line score above an earlier one
+		std::stable_sort(m_root_moves.begin(), m_root_moves.begin() + line_count, [](const RootMove& a, const RootMove& b) { return a.score > b.score; });
+
+		const RootMove& best_root_move = m_root_moves.front();
+
+		m_completed_depth = depth;
+		m_completed_selective_depth = m_selective_depth;
+		m_best_score = best_root_move.score;
+		m_best_move = best_root_move.move;
+		m_best_pv_length = best_root_move.pv_length;
+		std::copy(best_root_move.pv.begin(), best_root_move.pv.begin() + best_root_move.pv_length, m_best_pv.begin());
+
+		if (m_thread_index != 0)
+		{
+			continue;
+		}
+
+		report_iteration(depth, line_count);
+
+		// A mate within the requested number of moves is as good as it gets
+		if (limits.mate != 0 && m_best_score >= mate_score - static_cast<int>(2 * limits.mate - 1))
+		{
+			break;
+		}
+
+		if (m_time_manager != nullptr && m_time_manager->should_stop_after_iteration(m_best_move, m_best_score))
+		{
+			break;
+		}
 	}
-	else  // player is black
+
+	report_nodes();
+
+	return m_best_move;
+}
+
+int Search::search_root(size_t first_index, int alpha, int beta, unsigned int depth)
+{
+	const Position& position = m_stack[0].position;
+
+	int best_evaluation = -infinite_score;
+	size_t best_index = first_index;
+
+	for (size_t i = first_index; i < m_root_moves.size(); i++)
 	{
-		int min_evaluation = std::numeric_limits<int>::max();
-		const MoveList current_legal_moves = generate_legal_moves(position);
-		for (const Move& move : current_legal_moves)
+		const Move move = m_root_moves[i].move;
+
+		// The first root move is the best move from the previous iteration, so the PV continues through it.
+		m_following_pv = (i == first_index);
+
+		if (m_thread_index == 0 && m_time_manager != nullptr)
+		{
+			const int64_t elapsed = m_time_manager->get_elapsed_ms();
+
+			if (elapsed >= currmove_min_elapsed_ms && elapsed >= m_last_currmove_ms + currmove_interval_ms)
+			{
+				m_last_currmove_ms = elapsed;
+				uci_info_currmove(depth, move, i + 1);
+			}
+		}
+
+		m_stack[0].played_move = {true, get_colored_piece_index(position.get_player(), position.get_piece(move.get_from_square())), move.get_to_square().get_data(), position.is_capture(move)};
+
+		SearchStackEntry& child = m_stack[1];
+		child.extensions = 0;
+		child.position = position;
+		child.position.make_move(move);
+
+		int evaluation = 0;
+
+		if (i == first_index)
+		{
+			evaluation = -negamax(-beta, -alpha, depth - 1, 1, false);
+		}
+		else
 		{
-			Position temporary_position = position;
-			temporary_position.make_move(move);
-			int evaluation = minimaxi(temporary_position, alpha, beta, depth - 1);
-			min_evaluation = std::min(min_evaluation, evaluation);
-			beta = std::min(beta, evaluation);
-			if (beta <= alpha)
+			// Scout with a null window, re-search with the full window if the move might be better
+			evaluation = -negamax(-alpha - 1, -alpha, depth - 1, 1, true);
+
+			if (evaluation > alpha && evaluation < beta)
 			{
-				break;
+				evaluation = -negamax(-beta, -alpha, depth - 1, 1, false);
 			}
 		}
-		return min_evaluation;
+
+		// The iteration is thrown away, so leave the root moves and PV as they were
+		if (stop_requested())
+		{
+			return 0;
+		}
+
+		if (evaluation > best_evaluation)
+		{
+			best_evaluation = evaluation;
+			best_index = i;
+			update_pv(0, move);
+		}
+
+		alpha = std::max(alpha, evaluation);
+
+		if (alpha >= beta)
+		{
+			break;
+		}
 	}
+
+	// Seed the next iteration (or re-search) with the best move first in its line. Keep the rest in their previous order.
+	std::rotate(m_root_moves.begin() + first_index, m_root_moves.begin() + best_index, m_root_moves.begin() + best_index + 1);
+
+	RootMove& best_root_move = m_root_moves[first_index];
+	best_root_move.score = best_evaluation;
+	best_root_move.pv_length = m_stack[0].pv_length;
+	std::copy(m_stack[0].pv.begin(), m_stack[0].pv.begin() + m_stack[0].pv_length, best_root_move.pv.begin());
+
+	std::copy(best_root_move.pv.begin(), best_root_move.pv.begin() + best_root_move.pv_length, m_previous_pv.begin());
+	m_previous_pv_length = best_root_move.pv_length;
+
+	return best_evaluation;
 }
 
-// This can be done better. A quick fix for now.
-std::vector<unsigned int> Search::find_index_with_best_evaluation(const std::vector<int>& evaluations, const Color& player)
+int Search::negamax(int alpha, int beta, unsigned int depth, unsigned int ply, bool cut_node)
 {
-	int best_evaluation = (player == Color::White) ? -std::numeric_limits<int>::max() : std::numeric_limits<int>::max();
+	SearchStackEntry& entry = m_stack[ply];
+	const Position& position = entry.position;
+
+	entry.pv_length = ply;
+	m_selective_depth = std::max(m_selective_depth, ply);
+
+	// Scores of an interrupted search are meaningless. Every caller checks the flag before using them.
+	if (m_statistics.nodes % stop_poll_interval == 0)
+	{
+		poll_stop_signal();
+	}
 
-	for (unsigned int i = 0; i < evaluations.size(); i++)
+	if (stop_requested())
 	{
-		if (player == Color::White)
+		return 0;
+	}
+
+	m_statistics.nodes++;
+
+	// If we are at our max search depth then resolve captures and return the evaluation.
+	if (depth == 0 || ply >= max_search_ply)
+	{
+		m_following_pv = false;
+		m_statistics.nodes--;  // Counted by quiescence
+		return quiescence(alpha, beta, ply);
+	}
+
+	// Children are made into the next entry
+	SearchStackEntry& child = m_stack[ply + 1];
+	const PlayedMove* previous_move = (ply >= 1 && m_stack[ply - 1].played_move.valid) ? &m_stack[ply - 1].played_move : nullptr;
+
+	const bool pv_node = (beta - alpha > 1);
+	const uint64_t hash = position.get_hash();
+
+	m_key_history[m_root_key_index + ply] = hash;
+
+	if (ply > 0)
+	{
+		if (is_draw(position, ply))
+		{
+			m_following_pv = false;
+			return draw_score;
+		}
+
+		// The player to move can go back to a position of this line, so the node is worth at least a draw
+		if (alpha < draw_score && has_upcoming_repetition(position, ply))
 		{
-			if (evaluations[i] > best_evaluation)
+			alpha = draw_score;
+
+			if (alpha >= beta)
 			{
-				best_evaluation = evaluations[i];
+				m_following_pv = false;
+				return alpha;
 			}
 		}
-		else
+	}
+
+	const int original_alpha = alpha;
+
+	// In a singular extension search the node is searched without this move, so table entries for the node do not apply
+	const Move excluded_move = entry.excluded_move;
+	const bool excluded_search = (excluded_move != Move());
+
+	Move hash_move;
+	TTEntry tt_entry;
+	const bool tt_hit = !excluded_search && transposition_table.probe(hash, tt_entry);
+
+	if (tt_hit)
+	{
+		hash_move = tt_entry.move;
+
+		// Only cut at non-PV nodes, so the PV is not truncated by the table
+		if (!pv_node && tt_entry.depth >= depth)
 		{
-			if (evaluations[i] < best_evaluation)
+			const int tt_score = score_from_tt(tt_entry.score, ply);
+
+			if (tt_entry.bound == Bound::Exact || (tt_entry.bound == Bound::Lower && tt_score >= beta) || (tt_entry.bound == Bound::Upper && tt_score <= alpha))
 			{
-				best_evaluation = evaluations[i];
+				m_following_pv = false;
+				return tt_score;
 			}
 		}
 	}
 
-	// Checking if more moves has same evaluation
-	std::vector<unsigned int> best_indices;
-	for (unsigned int i = 0; i < evaluations.size(); i++)
+	const bool in_check = PositionAnalysis(position).player_in_check();
+
+	const int static_evaluation = in_check ? -infinite_score : evaluate_board(position, m_evaluation_type);
+	entry.static_evaluation = static_evaluation;
+	const bool after_null_move = (ply >= 1 && previous_move == nullptr);
+
+	// Internal iterative reduction: without a hash move the ordering is poor, so spend less on the node and let the table fill up
+	const bool following_pv_move = (m_following_pv && ply < m_previous_pv_length);
+	if ((pv_node || cut_node) && hash_move == Move() && !following_pv_move && depth >= internal_iterative_reduction_min_depth)
+	{
+		m_statistics.internal_iterative_reductions++;
+		depth--;
+	}
+
+	// The whole-node prunes below do not apply to singular extension searches, they only ask about the other moves
+
+	// Reverse futility pruning
+	if (!pv_node && !in_check && !excluded_search && depth < reverse_futility_margins.size() && static_evaluation < mate_bound && static_evaluation - reverse_futility_margins[depth] >= beta)
+	{
+		m_statistics.reverse_futility_prunes++;
+		m_following_pv = false;
+		return static_evaluation;
+	}
+
+	// Razoring, verified by a quiescence search
+	if (!pv_node && !in_check && !excluded_search && depth < razoring_margins.size() && static_evaluation + razoring_margins[depth] < alpha)
+	{
+		const int razor_evaluation = quiescence(alpha - 1, alpha, ply);
+
+		if (razor_evaluation < alpha)
+		{
+			m_statistics.razoring_prunes++;
+			m_following_pv = false;
+			return razor_evaluation;
+		}
+	}
+
+	// Null move pruning: if passing still fails high, a real move will almost surely do too
+	if (!pv_node && !in_check && !excluded_search && !after_null_move && ply >= m_null_move_min_ply && depth >= null_move_min_depth && static_evaluation >= beta &&
+		position.has_non_pawn_material(position.get_player()))
 	{
-		if (evaluations[i] == best_evaluation)
+		const unsigned int evaluation_reduction = std::min(static_cast<unsigned int>((static_evaluation - beta) / null_move_evaluation_divisor), null_move_max_evaluation_reduction);
+		const unsigned int reduction = null_move_base_reduction + depth / null_move_depth_divisor + evaluation_reduction;
+		const unsigned int null_depth = (depth > reduction) ? depth - reduction : 0;
+
+		entry.played_move.valid = false;
+
+		child.extensions = entry.extensions;
+		child.position = position;
+		child.position.make_null_move();
+
+		int null_evaluation = -negamax(-beta, -beta + 1, null_depth, ply + 1, !cut_node);
+
+		if (stop_requested())
+		{
+			return 0;
+		}
+
+		if (null_evaluation >= beta)
 		{
-			best_indices.push_back(i);
+			// Do not trust mate scores from a null move search
+			if (null_evaluation >= mate_bound)
+			{
+				null_evaluation = beta;
+			}
+
+			if (depth < null_move_verification_depth)
+			{
+				m_statistics.null_move_prunes++;
+				return null_evaluation;
+			}
+
+			// Verify with null moves disabled for the first part of the subtree
+			m_statistics.null_move_verifications++;
+			const unsigned int previous_null_move_min_ply = m_null_move_min_ply;
+			m_null_move_min_ply = ply + 3 * null_depth / 4;
+
+			const int verification = negamax(beta - 1, beta, null_depth, ply, false);
+
+			m_null_move_min_ply = previous_null_move_min_ply;
+			entry.pv_length = ply;
+
+			if (stop_requested())
+			{
+				return 0;
+			}
+
+			if (verification >= beta)
+			{
+				m_statistics.null_move_prunes++;
+				return null_evaluation;
+			}
 		}
 	}
-	std::cout << "Equally good moves: " << best_indices.size() << " - all possible moves: " << evaluations.size() << std::endl;
-	return best_indices;
-}
\ No newline at end of file
+
+	// ProbCut
+	const int probcut_beta = beta + probcut_margin;
+	const bool tt_rules_out_probcut = (tt_hit && tt_entry.depth + 3u >= depth && score_from_tt(tt_entry.score, ply) < probcut_beta);
+
+	if (!pv_node && !in_check && !excluded_search && depth >= probcut_min_depth && std::abs(beta) < mate_bound && !tt_rules_out_probcut)
+	{
+		// Only the captures are needed, not the full move list
+		generate_legal_captures(position, entry.moves);
+		MovePicker capture_picker(position, entry.moves, hash_move);
+
+		Move capture;
+		while (capture_picker.next(capture))
+		{
+			// Only captures that win enough material to beat the raised beta are worth trying
+			if (!see(position, capture, probcut_beta - static_evaluation))
+			{
+				continue;
+			}
+
+			entry.played_move = {true, get_colored_piece_index(position.get_player(), position.get_piece(capture.get_from_square())), capture.get_to_square().get_data(), true};
+
+			child.extensions = entry.extensions;
+			child.position = position;
+			child.position.make_move(capture);
+
+			// Cheap quiescence test first, then the reduced search
+			int probcut_evaluation = -quiescence(-probcut_beta, -probcut_beta + 1, ply + 1);
+
+			if (probcut_evaluation >= probcut_beta)
+			{
+				probcut_evaluation = -negamax(-probcut_beta, -probcut_beta + 1, depth - probcut_depth_reduction, ply + 1, !cut_node);
+			}
+
+			if (stop_requested())
+			{
+				return 0;
+			}
+
+			if (probcut_evaluation >= probcut_beta)
+			{
+				m_statistics.probcut_prunes++;
+				transposition_table.store(hash, capture, score_to_tt(probcut_evaluation, ply), depth - probcut_depth_reduction + 1, Bound::Lower);
+				return probcut_evaluation;
+			}
+		}
+	}
+
+	// A singular extension search at this ply generates into the same buffer, the move picker keeps its own copy
+	MoveList& current_legal_moves = entry.moves;
+	generate_legal_moves(position, current_legal_moves);
+
+	// Checkmate or stalemate
+	if (current_legal_moves.empty())
+	{
+		m_following_pv = false;
+		return in_check ? -mate_score + static_cast<int>(ply) : draw_score;
+	}
+
+	const Move pv_move = get_pv_move(current_legal_moves, ply);
+	if (pv_move != Move())
+	{
+		hash_move = pv_move;
+	}
+
+	const Move counter_move = (previous_move != nullptr) ? m_counter_moves.get(previous_move->piece_index, Square(previous_move->to_square)) : Move();
+	const QuietHistory quiet_history(m_history, get_continuation_table(ply, 1), get_continuation_table(ply, 2));
+
+	MovePicker move_picker(position, current_legal_moves, hash_move, entry.killers, counter_move, quiet_history);
+
+	int best_evaluation = -infinite_score;
+	Move best_move;
+
+	std::array<Move, max_moves> quiets_searched;
+	size_t quiet_count = 0;
+	size_t move_count = 0;
+
+	// ABDADA: moves put off in the first pass, searched once the move picker runs out
+	std::array<Move, max_moves> deferred_moves;
+	size_t deferred_count = 0;
+	size_t deferred_index = 0;
+	bool revisiting = false;
+
+	const auto next_move = [&](Move& move)
+	{
+		if (move_picker.next(move))
+		{
+			return true;
+		}
+
+		revisiting = true;
+
+		if (deferred_index < deferred_count)
+		{
+			move = deferred_moves[deferred_index++];
+			return true;
+		}
+
+		return false;
+	};
+
+	Move move;
+	while (next_move(move))
+	{
+		if (move == excluded_move)
+		{
+			continue;
+		}
+
+		const bool capture = position.is_capture(move);
+		const bool quiet = !capture && convert_promo_to_piece(move.get_type()) == Piece::Empty;
+
+		const bool may_prune = !pv_node && !in_check && move_count > 0 && best_evaluation > -mate_bound;
+
+		// Late move pruning: with good move ordering the late quiet moves at shallow depth are almost never best
+		if (may_prune && quiet && depth <= late_move_pruning_max_depth && quiet_count >= late_move_pruning_counts[depth])
+		{
+			m_statistics.late_move_prunes++;
+			continue;
+		}
+
+		// Futility pruning
+		if (may_prune && quiet && depth < futility_margins.size() && static_evaluation + futility_margins[depth] <= alpha)
+		{
+			m_statistics.futility_prunes++;
+			continue;
+		}
+
+		// Skip quiet moves that hang material
+		if (may_prune && quiet && depth <= see_quiet_pruning_max_depth &&
+			!see(position, move, -see_quiet_pruning_margin * static_cast<int>(depth * depth)))
+		{
+			m_statistics.see_quiet_prunes++;
+			continue;
+		}
+
+		unsigned int extension = 0;
+		const bool may_extend = entry.extensions < m_extension_budget;
+
+		// Singular extension: is the hash move much better than every alternative?
+		if (may_extend && move == hash_move && tt_hit && tt_entry.move == move && ply > 0 && depth >= singular_extension_min_depth && tt_entry.depth + 3u >= depth &&
+			tt_entry.bound != Bound::Upper && std::abs(score_from_tt(tt_entry.score, ply)) < mate_bound)
+		{
+			const int singular_beta = score_from_tt(tt_entry.score, ply) - singular_extension_margin_per_depth * static_cast<int>(depth);
+			const bool was_following_pv = m_following_pv;
+
+			m_following_pv = false;
+			entry.excluded_move = move;
+			const int singular_evaluation = negamax(singular_beta - 1, singular_beta, (depth - 1) / 2, ply, cut_node);
+			entry.excluded_move = Move();
+			m_following_pv = was_following_pv;
+			entry.pv_length = ply;
+
+			if (stop_requested())
+			{
+				return 0;
+			}
+
+			if (singular_evaluation < singular_beta)
+			{
+				m_statistics.singular_extensions++;
+				extension = 1;
+			}
+			else if (singular_beta >= beta)
+			{
+				// Multi-cut: even without the hash move another move beats beta
+				return singular_beta;
+			}
+		}
+
+		entry.played_move = {true, get_colored_piece_index(position.get_player(), position.get_piece(move.get_from_square())), move.get_to_square().get_data(), capture};
+
+		child.position = position;
+		child.position.make_move(move);
+
+		// ABDADA with young brothers wait: the first move is searched right away, later moves another thread is busy with are put off
+		const uint64_t child_hash = child.position.get_hash();
+		const bool exclusive = m_parallel_search_type == ParallelSearchType::ABDADA && move_count > 0 && depth >= abdada_min_depth;
+
+		if (exclusive && !revisiting && transposition_table.is_busy(child_hash))
+		{
+			m_statistics.abdada_deferrals++;
+			deferred_moves[deferred_count++] = move;
+			continue;
+		}
+
+		const bool gives_check = PositionAnalysis(child.position).player_in_check();
+
+		if (may_extend && extension == 0)
+		{
+			const bool recapture = capture && previous_move != nullptr && previous_move->capture && previous_move->to_square == move.get_to_square().get_data();
+
+			if (gives_check)
+			{
+				m_statistics.check_extensions++;
+				extension = 1;
+			}
+			else if (recapture && pv_node)
+			{
+				m_statistics.recapture_extensions++;
+				extension = 1;
+			}
+		}
+
+		child.extensions = entry.extensions + extension;
+		const unsigned int new_depth = depth - 1 + extension;
+
+		int evaluation = 0;
+
+		if (exclusive)
+		{
+			transposition_table.set_busy(child_hash);
+		}
+
+		if (move_count == 0)
+		{
+			evaluation = -negamax(-beta, -alpha, new_depth, ply + 1, !pv_node && !cut_node);
+		}
+		else
+		{
+			unsigned int reduction = 0;
+
+			// Late move reductions: search late quiet moves shallower first
+			if (quiet && !gives_check && depth >= late_move_reduction_min_depth && move_count >= (pv_node ? 3u : 2u))
+			{
+				int signed_reduction = late_move_reductions[depth][std::min(move_count, max_moves - 1)];
+
+				signed_reduction -= pv_node ? 1 : 0;
+				signed_reduction -= in_check ? 1 : 0;
+				signed_reduction += cut_node ? 1 : 0;
+				signed_reduction -= quiet_history.get(position.get_player(), position.get_piece(move.get_from_square()), move) / late_move_reduction_history_divisor;
+
+				// Never drop into quiescence search directly, and never extend
+				reduction = static_cast<unsigned int>(std::clamp(signed_reduction, 0, static_cast<int>(new_depth) - 1));
+			}
+
+			// Scout with a null window, re-search with the full window if the move might be better
+			evaluation = -negamax(-alpha - 1, -alpha, new_depth - reduction, ply + 1, true);
+
+			if (reduction > 0)
+			{
+				m_statistics.late_move_reductions++;
+
+				if (evaluation > alpha)
+				{
+					m_statistics.late_move_re_searches++;
+					evaluation = -negamax(-alpha - 1, -alpha, new_depth, ply + 1, !cut_node);
+				}
+			}
+
+			if (evaluation > alpha && evaluation < beta)
+			{
+				evaluation = -negamax(-beta, -alpha, new_depth, ply + 1, false);
+			}
+		}
+
+		if (exclusive)
+		{
+			transposition_table.clear_busy(child_hash);
+		}
+
+		if (stop_requested())
+		{
+			return 0;
+		}
+
+		move_count++;
+
+		if (evaluation > best_evaluation)
+		{
+			best_evaluation = evaluation;
+			best_move = move;
+
+			if (evaluation > alpha)
+			{
+				alpha = evaluation;
+				update_pv(ply, move);
+			}
+		}
+
+		if (alpha >= beta)
+		{
+			m_statistics.beta_cutoffs++;
+			if (move_count == 1)
+			{
+				m_statistics.first_move_beta_cutoffs++;
+			}
+
+			if (quiet)
+			{
+				update_quiet_statistics(position, move, quiets_searched, quiet_count, depth, ply);
+			}
+			break;
+		}
+
+		if (quiet)
+		{
+			quiets_searched[quiet_count++] = move;
+		}
+	}
+
+	if (!excluded_search)
+	{
+		const Bound bound = (best_evaluation >= beta) ? Bound::Lower : ((best_evaluation > original_alpha) ? Bound::Exact : Bound::Upper);
+		transposition_table.store(hash, best_move, score_to_tt(best_evaluation, ply), depth, bound);
+	}
+
+	return best_evaluation;
+}
+
+int Search::quiescence(int alpha, int beta, unsigned int ply)
+{
+	SearchStackEntry& entry = m_stack[ply];
+	const Position& position = entry.position;
+
+	if (m_statistics.nodes % stop_poll_interval == 0)
+	{
+		poll_stop_signal();
+	}
+
+	if (stop_requested())
+	{
+		return 0;
+	}
+
+	m_statistics.nodes++;
+	m_statistics.quiescence_nodes++;
+	m_selective_depth = std::max(m_selective_depth, ply);
+
+	const int stand_pat = evaluate_board(position, m_evaluation_type);
+
+	if (ply >= max_search_ply)
+	{
+		return stand_pat;
+	}
+
+	const int original_alpha = alpha;
+	const uint64_t hash = position.get_hash();
+
+	m_key_history[m_root_key_index + ply] = hash;
+
+	if (is_draw(position, ply))
+	{
+		return draw_score;
+	}
+
+	Move hash_move;
+	TTEntry tt_entry;
+
+	// Any entry is deep enough here, quiescence entries are stored at depth 0
+	if (transposition_table.probe(hash, tt_entry))
+	{
+		hash_move = tt_entry.move;
+
+		const int tt_score = score_from_tt(tt_entry.score, ply);
+
+		if (tt_entry.bound == Bound::Exact || (tt_entry.bound == Bound::Lower && tt_score >= beta) || (tt_entry.bound == Bound::Upper && tt_score <= alpha))
+		{
+			return tt_score;
+		}
+	}
+
+	// The player is not forced to capture, so the static evaluation is a lower bound
+	int best_evaluation = stand_pat;
+
+	if (best_evaluation >= beta)
+	{
+		return best_evaluation;
+	}
+
+	alpha = std::max(alpha, best_evaluation);
+
+	generate_legal_captures(position, entry.moves);
+	MovePicker move_picker(position, entry.moves, hash_move);
+
+	Move best_move;
+	Move move;
+
+	while (move_picker.next(move))
+	{
+		const MoveType type = move.get_type();
+		const Piece promotion = convert_promo_to_piece(type);
+		const bool capture = position.is_capture(move);
+
+		// Quiet underpromotions are never better than the queen promotion
+		if (!capture && promotion != Piece::Queen)
+		{
+			continue;
+		}
+
+		// Delta pruning: even winning the piece for free would not raise alpha
+		if (promotion == Piece::Empty)
+		{
+			const Piece victim = (type == MoveType::EnPassant) ? Piece::Pawn : position.get_piece(move.get_to_square());
+
+			if (stand_pat + get_piece_value(victim) + delta_pruning_margin <= alpha)
+			{
+				m_statistics.delta_prunes++;
+				continue;
+			}
+
+			// Losing captures cannot raise the stand pat score
+			if (!see(position, move, 0))
+			{
+				m_statistics.see_quiescence_prunes++;
+				continue;
+			}
+		}
+
+		Position& child_position = m_stack[ply + 1].position;
+		child_position = position;
+		child_position.make_move(move);
+
+		const int evaluation = -quiescence(-beta, -alpha, ply + 1);
+
+		if (stop_requested())
+		{
+			return 0;
+		}
+
+		if (evaluation > best_evaluation)
+		{
+			best_evaluation = evaluation;
+			best_move = move;
+
+			if (evaluation > alpha)
+			{
+				alpha = evaluation;
+			}
+		}
+
+		if (alpha >= beta)
+		{
+			break;
+		}
+	}
+
+	const Bound bound = (best_evaluation >= beta) ? Bound::Lower : ((best_evaluation > original_alpha) ? Bound::Exact : Bound::Upper);
+	transposition_table.store(hash, best_move, score_to_tt(best_evaluation, ply), 0, bound);
+
+	return best_evaluation;
+}
+
+bool Search::is_draw(const Position& position, unsigned int ply) const
+{
+	const unsigned int halfmove_clock = position.get_halfmove_clock();
+
+	// Checkmate takes precedence over the fifty-move rule
+	if (halfmove_clock >= fifty_move_plies && (!PositionAnalysis(position).player_in_check() || !generate_legal_moves(position).empty()))
+	{
+		return true;
+	}
+
+	// Only positions since the last irreversible move can repeat, and only those with the same player to move
+	const size_t index = m_root_key_index + ply;
+	const size_t max_distance = std::min<size_t>(std::min(halfmove_clock, position.get_plies_from_null()), index);
+	const uint64_t hash = position.get_hash();
+
+	bool repeated_before_root = false;
+
+	for (size_t distance = 4; distance <= max_distance; distance += 2)
+	{
+		if (m_key_history[index - distance] == hash)
+		{
+			if (distance < ply || repeated_before_root)
+			{
+				return true;
+			}
+			repeated_before_root = true;
+		}
+	}
+
+	return false;
+}
+
+bool Search::has_upcoming_repetition(const Position& position, unsigned int ply) const
+{
+	const size_t index = m_root_key_index + ply;
+	const size_t max_distance = std::min<size_t>(std::min(position.get_halfmove_clock(), position.get_plies_from_null()), ply - 1);
+
+	if (max_distance < 3)
+	{
+		return false;
+	}
+
+	const uint64_t hash = position.get_hash();
+	const Bitboard occupancy = position.get_bitboard(Color::White) | position.get_bitboard(Color::Black);
+
+	// The positions an odd number of plies back have the other player to move, one move away from this one.
+	// Only positions after the root are considered, reaching the root position again is not yet a draw.
+	for (size_t distance = 3; distance <= max_distance; distance += 2)
+	{
+		const CuckooEntry* entry = find_cuckoo_entry(hash ^ m_key_history[index - distance]);
+
+		if (entry != nullptr && (entry->between & occupancy).empty())
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void Search::update_pv(unsigned int ply, const Move& move)
+{
+	SearchStackEntry& entry = m_stack[ply];
+	const SearchStackEntry& child = m_stack[ply + 1];
+
+	entry.pv[ply] = move;
+	std::copy(child.pv.begin() + ply + 1, child.pv.begin() + child.pv_length, entry.pv.begin() + ply + 1);
+	entry.pv_length = child.pv_length;
+}
+
+Move Search::get_pv_move(const MoveList& moves, unsigned int ply)
+{
+	if (!m_following_pv || ply >= m_previous_pv_length)
+	{
+		m_following_pv = false;
+		return Move();
+	}
+
+	const Move& pv_move = m_previous_pv[ply];
+
+	if (std::find(moves.begin(), moves.end(), pv_move) == moves.end())
+	{
+		m_following_pv = false;
+		return Move();
+	}
+
+	return pv_move;
+}
+
+void Search::update_quiet_statistics(const Position& position, const Move& best_move, const std::array<Move, max_moves>& quiets_searched, size_t quiet_count, unsigned int depth,
+									 unsigned int ply)
+{
+	const Color player = position.get_player();
+	const int bonus = history_bonus(depth);
+
+	store_killer(m_stack[ply].killers, best_move);
+
+	if (ply >= 1 && m_stack[ply - 1].played_move.valid)
+	{
+		const PlayedMove& previous_move = m_stack[ply - 1].played_move;
+		m_counter_moves.set(previous_move.piece_index, Square(previous_move.to_square), best_move);
+	}
+
+	std::array<PieceToHistory*, 2> continuation_tables = {get_continuation_table(ply, 1), get_continuation_table(ply, 2)};
+
+	auto update_move = [&](const Move& move, int move_bonus)
+	{
+		m_history.update(player, move, move_bonus);
+
+		const size_t piece_index = get_colored_piece_index(player, position.get_piece(move.get_from_square()));
+
+		for (PieceToHistory* continuation_table : continuation_tables)
+		{
+			if (continuation_table != nullptr)
+			{
+				continuation_table->update(piece_index, move.get_to_square(), move_bonus);
+			}
+		}
+	};
+
+	update_move(best_move, bonus);
+
+	for (size_t i = 0; i < quiet_count; i++)
+	{
+		update_move(quiets_searched[i], -bonus);
+	}
+}
+
+PieceToHistory* Search::get_continuation_table(unsigned int ply, unsigned int plies_back)
+{
+	if (ply < plies_back || !m_stack[ply - plies_back].played_move.valid)
+	{
+		return nullptr;
+	}
+
+	const PlayedMove& played_move = m_stack[ply - plies_back].played_move;
+
+	return &m_continuation_history[plies_back - 1].get(played_move.piece_index, Square(played_move.to_square));
+}
@@ -4,11 +4,59 @@
 #include "evaluation/evaluation_type.hpp"
 #include "movegen/movegen.hpp"
 #include "position/Position.hpp"
+#include "search/History.hpp"
+#include "search/SearchLimits.hpp"
+#include "search/SearchStack.hpp"
+#include "search/TimeManager.hpp"
+#include "search/parallel_search_type.hpp"
+#include "search/score.hpp"
 
-#include <iostream>
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <limits>
+#include <span>
 #include <vector>
 
+struct SearchStatistics
+{
+	uint64_t nodes = 0;
+	uint64_t quiescence_nodes = 0;  // Included in nodes
+
+	uint64_t delta_prunes = 0;
+	uint64_t see_quiescence_prunes = 0;
+	uint64_t see_quiet_prunes = 0;
+
+	uint64_t reverse_futility_prunes = 0;
+	uint64_t razoring_prunes = 0;
+	uint64_t futility_prunes = 0;
+
+	uint64_t null_move_prunes = 0;
+	uint64_t null_move_verifications = 0;  // Verification searches run, whether or not they confirmed the prune
+
+	uint64_t probcut_prunes = 0;
+
+	uint64_t check_extensions = 0;
+	uint64_t singular_extensions = 0;
+	uint64_t recapture_extensions = 0;
+	uint64_t internal_iterative_reductions = 0;
+
+	uint64_t abdada_deferrals = 0;  // Moves put off because another thread was searching them
+
+	uint64_t late_move_reductions = 0;
+	uint64_t late_move_re_searches = 0;  // Reduced searches that failed high and were searched again at full depth
+	uint64_t late_move_prunes = 0;
+
+	// Move ordering quality: how often a beta cutoff came from the first move searched
+	uint64_t beta_cutoffs = 0;
+	uint64_t first_move_beta_cutoffs = 0;
+
+	double get_first_move_cutoff_rate() const
+	{
+		return (beta_cutoffs == 0) ? 0.0 : static_cast<double>(first_move_beta_cutoffs) / beta_cutoffs;
+	}
+};
+
 class Search
 {
 public:  // Methods.
@@ -18,16 +66,142 @@ public:  // Methods.
 
 	void set_evaluation_type(EVALUATION_TYPE evaluation_type);
 
-	std::vector<unsigned int> search_for_best_move(const Position& position, const MoveList& legal_moves, const unsigned int search_depth);
+	// Forget everything learned in previous searches, for a new game
+	void clear();
+
+	// Iterative deepening from depth 1 up to the depth limit. Returns the best move of the deepest completed iteration.
+	// key_history holds the hashes of the game positions before this one, oldest first, for repetition detection.
+	Move search_for_best_move(const Position& position, std::span<const uint64_t> key_history, const MoveList& legal_moves, const SearchLimits& limits);
+
+	// The search unwinds as soon as the signal is set, keeping the result of the last completed iteration.
+	// The thread with a time manager also enforces the time, node and mate limits by setting the signal.
+	void set_stop_signal(std::atomic<bool>* stop_signal);
+	void set_time_manager(TimeManager* time_manager);
+
+	// Nodes of all threads are added up here every few nodes, for the node limit and the info output
+	void set_node_counter(std::atomic<uint64_t>* node_counter);
+
+	// Thread 0 reports progress, helper threads skip some iterations so they do not all search the same depth
+	void set_thread_index(size_t thread_index);
+
+	void set_parallel_search_type(ParallelSearchType parallel_search_type);
+
+	// Number of best lines to search and report, for analysis
+	void set_multi_pv(unsigned int line_count);
+
+	const SearchStatistics& get_statistics() const;
+
+	// Result of the last completed iteration
+	unsigned int get_completed_depth() const;
+	unsigned int get_completed_selective_depth() const;
+	int get_best_score() const;
+	Move get_best_move() const;
+	std::span<const Move> get_best_pv() const;
 
 private:  // Methods.
-	int minimaxi(const Position& position, int alpha, int beta, unsigned int depth);
+	// Search the root moves from first_index on to the given depth within the (alpha, beta) window.
+	// The best of them is moved to first_index, with its score and PV.
+	int search_root(size_t first_index, int alpha, int beta, unsigned int depth);
+
+	// Set once the stop signal has been seen, the search then unwinds without using any scores
+	bool stop_requested() const;
+	void poll_stop_signal();
+
+	void report_nodes();
+	uint64_t get_total_nodes() const;
 
-	// Find index with best evaluation for that player. If more evaluation is equal, we chose random.
-	std::vector<unsigned int> find_index_with_best_evaluation(const std::vector<int>& evaluations, const Color& player);
+	// Main thread, UCI info for each line after an iteration
+	void report_iteration(unsigned int depth, size_t line_count);
+
+	// Whether this thread leaves out the given iteration. Only Lazy SMP helper threads skip iterations.
+	bool skip_depth(unsigned int depth) const;
+
+	// Principal variation search in negamax form on the position of the search stack entry at ply. Scores are relative to the player to move.
+	// cut_node is set for null window nodes expected to fail high.
+	int negamax(int alpha, int beta, unsigned int depth, unsigned int ply, bool cut_node);
+
+	// The position at ply repeats an earlier one, or the fifty-move rule applies.
+	// A repetition after the root is enough, a position from the root or before it must have occurred twice.
+	bool is_draw(const Position& position, unsigned int ply) const;
+
+	// A single reversible move leads back to a position of the current line, so the player to move can force at least a draw
+	bool has_upcoming_repetition(const Position& position, unsigned int ply) const;
+
+	// Continuation history table for the move played plies_back before the node at ply, nullptr if there is none
+	PieceToHistory* get_continuation_table(unsigned int ply, unsigned int plies_back);
+
+	// Search captures and promotions until the position is quiet, so leaves are not evaluated in the middle of an exchange
+	int quiescence(int alpha, int beta, unsigned int ply);
+
+	// The move becomes the first of the PV at ply, followed by the PV of the child
+	void update_pv(unsigned int ply, const Move& move);
+
+	// The principal variation move of the previous iteration, if we are still following it
+	Move get_pv_move(const MoveList& moves, unsigned int ply);
+
+	// Reward the quiet move causing a beta cutoff, punish the quiet moves searched before it
+	void update_quiet_statistics(const Position& position, const Move& best_move, const std::array<Move, max_moves>& quiets_searched, size_t quiet_count, unsigned int depth,
+								 unsigned int ply);
 
 private:  // Variables.
 	EVALUATION_TYPE m_evaluation_type;
+
+	std::atomic<bool>* m_stop_signal = nullptr;
+	bool m_stopped = false;
+
+	TimeManager* m_time_manager = nullptr;
+	uint64_t m_node_limit = 0;
+
+	std::atomic<uint64_t>* m_node_counter = nullptr;
+	uint64_t m_reported_nodes = 0;
+	size_t m_thread_index = 0;
+	ParallelSearchType m_parallel_search_type = ParallelSearchType::LazySMP;
+
+	unsigned int m_completed_depth = 0;
+	unsigned int m_completed_selective_depth = 0;
+	int m_best_score = 0;
+	Move m_best_move;
+	std::array<Move, max_search_ply + 1> m_best_pv;
+	unsigned int m_best_pv_length = 0;
+
+	// Per-ply state of the current line, allocated with the search so the recursion does not allocate
+	std::vector<SearchStackEntry> m_stack;
+
+	// Principal variation of the last completed iteration, used to seed move ordering.
+	std::array<Move, max_search_ply + 1> m_previous_pv;
+	unsigned int m_previous_pv_length = 0;
+	bool m_following_pv = false;
+
+	// A root move with the score and PV it got when it was last searched as the best of its line
+	struct RootMove
+	{
+		Move move;
+		int score = -infinite_score;
+		std::array<Move, max_search_ply + 1> pv;
+		unsigned int pv_length = 0;
+	};
+	std::vector<RootMove> m_root_moves;  // The first m_multi_pv moves are the lines, best first
+	unsigned int m_multi_pv = 1;
+
+	unsigned int m_selective_depth = 0;  // Highest ply reached in the current iteration
+	int64_t m_last_currmove_ms = 0;
+
+	// Hashes of the game positions followed by the positions of the current line, the root is at m_root_key_index
+	std::vector<uint64_t> m_key_history;
+	size_t m_root_key_index = 0;
+
+	// Move ordering
+	ButterflyHistory m_history;
+	CounterMoves m_counter_moves;
+	std::array<ContinuationHistory, 2> m_continuation_history;  // One and two plies back
+
+	// No null move pruning before this ply, set while a verification search is running
+	unsigned int m_null_move_min_ply = 0;
+
+	// Bound for the extensions along a line in the current iteration
+	unsigned int m_extension_budget = 0;
+
+	SearchStatistics m_statistics;
 };
 
 #endif  // SEARCH_SEARCH_HPP
@@ -0,0 +1,35 @@
+#ifndef SEARCH_SEARCHLIMITS_HPP
+#define SEARCH_SEARCHLIMITS_HPP
+
+#include "types/Move.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// The arguments of the UCI go command. Times are in milliseconds.
+struct SearchLimits
+{
+	std::optional<int64_t> white_time;
+	std::optional<int64_t> black_time;
+	int64_t white_increment = 0;
+	int64_t black_increment = 0;
+	unsigned int moves_to_go = 0;  // 0 if not given, the clock covers the rest of the game
+	std::optional<int64_t> move_time;
+
+	unsigned int depth = 0;  // 0 if not given
+	uint64_t nodes = 0;      // 0 if not given
+	unsigned int mate = 0;   // Mate in this many moves, 0 if not given
+
+	bool infinite = false;
+	bool ponder = false;
+
+	std::vector<Move> search_moves;  // Only search these root moves, all moves if empty
+
+	bool has_time_limit() const
+	{
+		return white_time.has_value() || black_time.has_value() || move_time.has_value();
+	}
+};
+
+#endif  // SEARCH_SEARCHLIMITS_HPP
@@ -0,0 +1,47 @@
+#ifndef SEARCH_SEARCHSTACK_HPP
+#define SEARCH_SEARCHSTACK_HPP
+
+#include "movegen/movegen.hpp"
+#include "position/Position.hpp"
+#include "search/History.hpp"
+#include "search/score.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// The move played at a ply, for the move-pair tables
+struct PlayedMove
+{
+	bool valid = false;  // Not valid after a null move
+	size_t piece_index = 0;
+	uint8_t to_square = 0;
+	bool capture = false;
+};
+
+// Everything the search keeps for one ply. A node at ply makes its children into the entry at ply + 1,
+// so the recursion works in memory that was allocated before the search and stays in cache.
+struct SearchStackEntry
+{
+	Position position;
+	MoveList moves;  // Move generation buffer, reserved for max_moves so it never reallocates
+
+	int static_evaluation = 0;
+
+	PlayedMove played_move;
+	Move excluded_move;  // Skipped during a singular extension search
+
+	KillerMoves killers;
+
+	// Extensions along the current line up to this ply
+	unsigned int extensions = 0;
+
+	// PV of the node at this ply, from index ply up to pv_length, so the PV of the child can be copied over as is
+	std::array<Move, max_search_ply + 1> pv;
+	unsigned int pv_length = 0;
+};
+
+// One entry per ply, from the root up to and including max_search_ply
+constexpr size_t search_stack_size = max_search_ply + 1;
+
+#endif  // SEARCH_SEARCHSTACK_HPP
@@ -0,0 +1,206 @@
+#include "ThreadPool.hpp"
+
+#include "console/uci_output.hpp"
+#include "search/TranspositionTable.hpp"
+
+#include <algorithm>
+#include <thread>
+
+// Added to every vote so the worst scoring thread still counts
+constexpr int64_t vote_score_offset = 14;
+
+ThreadPool::ThreadPool(EVALUATION_TYPE evaluation_type) : m_evaluation_type(evaluation_type), m_monte_carlo_tree_search(evaluation_type)
+{
+	set_thread_count(1);
+
+	m_proof_number_search.set_stop_signal(&m_stop);
+	m_proof_number_search.set_node_counter(&m_nodes);
+	m_proof_number_search.set_time_manager(&m_time_manager);
+
+	m_monte_carlo_tree_search.set_stop_signal(&m_stop);
+	m_monte_carlo_tree_search.set_node_counter(&m_nodes);
+	m_monte_carlo_tree_search.set_time_manager(&m_time_manager);
+}
+
+void ThreadPool::set_thread_count(size_t thread_count)
+{
+	thread_count = std::max<size_t>(thread_count, 1);
+
+	while (m_searches.size() > thread_count)
+	{
+		m_searches.pop_back();
+	}
+
+	while (m_searches.size() < thread_count)
+	{
+		auto search = std::make_unique<Search>(m_evaluation_type);
+		search->set_stop_signal(&m_stop);
+		search->set_node_counter(&m_nodes);
+		search->set_time_manager(m_searches.empty() ? &m_time_manager : nullptr);
+		search->set_thread_index(m_searches.size());
+		search->set_parallel_search_type(m_parallel_search_type);
+		m_searches.push_back(std::move(search));
+	}
+}
+
+size_t ThreadPool::get_thread_count() const
+{
+	return m_searches.size();
+}
+
+void ThreadPool::set_parallel_search_type(ParallelSearchType parallel_search_type)
+{
+	m_parallel_search_type = parallel_search_type;
+	transposition_table.set_busy_counters(parallel_search_type == ParallelSearchType::ABDADA);
+
+	for (const std::unique_ptr<Search>& search : m_searches)
+	{
+		search->set_parallel_search_type(parallel_search_type);
+	}
+}
+
+void ThreadPool::set_search_algorithm(SearchAlgorithm search_algorithm)
+{
+	m_search_algorithm = search_algorithm;
+}
+
+void ThreadPool::set_multi_pv(unsigned int line_count)
+{
+	m_multi_pv = line_count;
+	m_searches.front()->set_multi_pv(line_count);
+}
+
+void ThreadPool::clear()
+{
+	for (const std::unique_ptr<Search>& search : m_searches)
+	{
+		search->clear();
+	}
+
+	m_monte_carlo_tree_search.clear();
+}
+
+void ThreadPool::start_clock(const SearchLimits& limits, Color player)
+{
+	m_time_manager.start(limits, player);
+}
+
+void ThreadPool::ponderhit()
+{
+	m_time_manager.ponderhit();
+}
+
+Move ThreadPool::search_for_best_move(const Position& position, std::span<const uint64_t> key_history, const MoveList& legal_moves, const SearchLimits& limits)
+{
+	transposition_table.new_search();
+	m_nodes = 0;
+
+	// A proven mate is the answer. Otherwise alpha-beta gets what is left of the limits, and finds a move anyway.
+	if (limits.mate != 0)
+	{
+		const Move mate_move = m_proof_number_search.search_for_mate(position, limits);
+
+		if (mate_move != Move())
+		{
+			return mate_move;
+		}
+	}
+
+	if (m_search_algorithm == SearchAlgorithm::MCTS)
+	{
+		return m_monte_carlo_tree_search.search_for_best_move(position, key_history, legal_moves, limits, m_searches.size());
+	}
+
+	std::vector<std::thread> helpers;
+
+	for (size_t i = 1; i < m_searches.size(); i++)
+	{
+		helpers.emplace_back([this, i, &position, key_history, &legal_moves, &limits]() { m_searches[i]->search_for_best_move(position, key_history, legal_moves, limits); });
+	}
+
+	m_searches.front()->search_for_best_move(position, key_history, legal_moves, limits);
+
+	m_stop = true;
+
+	for (std::thread& helper : helpers)
+	{
+		helper.join();
+	}
+
+	const size_t best_thread = select_best_thread();
+	const Search& best_search = *m_searches[best_thread];
+
+	// The GUI shows the last info line with the move played, so it has to be the line of the chosen thread
+	if (best_thread != 0)
+	{
+		uci_info(1, best_search.get_completed_depth(), best_search.get_completed_selective_depth(), best_search.get_best_score(), m_nodes.load(std::memory_order_relaxed),
+				 m_time_manager.get_elapsed_ms(), transposition_table.get_hashfull(), best_search.get_best_pv());
+	}
+
+	return best_search.get_best_move();
+}
+
+void ThreadPool::stop()
+{
+	m_stop = true;
+}
+
+void ThreadPool::clear_stop()
+{
+	m_stop = false;
+}
+
+uint64_t ThreadPool::get_nodes() const
+{
+	return m_nodes;
+}
+
+size_t ThreadPool::select_best_thread() const
+{
+	const Search& main_search = *m_searches.front();
+
+	if (m_parallel_search_type == ParallelSearchType::ABDADA || m_multi_pv > 1)
+	{
+		return 0;
+	}
+
+	int min_score = main_search.get_best_score();
+
+	for (const std::unique_ptr<Search>& search : m_searches)
+	{
+		if (search->get_completed_depth() > 0)
+		{
+			min_score = std::min(min_score, search->get_best_score());
+		}
+	}
+
+	// Total weight behind the move of each thread. Ties go to the lower thread index, so to the main thread first.
+	size_t best_thread = 0;
+	int64_t best_votes = -1;
+
+	for (size_t i = 0; i < m_searches.size(); i++)
+	{
+		if (m_searches[i]->get_completed_depth() == 0)
+		{
+			continue;
+		}
+
+		int64_t votes = 0;
+
+		for (const std::unique_ptr<Search>& voter : m_searches)
+		{
+			if (voter->get_completed_depth() > 0 && voter->get_best_move() == m_searches[i]->get_best_move())
+			{
+				votes += (voter->get_best_score() - min_score + vote_score_offset) * voter->get_completed_depth();
+			}
+		}
+
+		if (votes > best_votes)
+		{
+			best_votes = votes;
+			best_thread = i;
+		}
+	}
+
+	return best_thread;
+}
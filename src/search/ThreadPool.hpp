@@ -0,0 +1,79 @@
+#ifndef SEARCH_THREADPOOL_HPP
+#define SEARCH_THREADPOOL_HPP
+
+#include "evaluation/evaluation_type.hpp"
+#include "movegen/movegen.hpp"
+#include "position/Position.hpp"
+#include "search/MonteCarloTreeSearch.hpp"
+#include "search/ProofNumberSearch.hpp"
+#include "search/Search.hpp"
+#include "search/SearchLimits.hpp"
+#include "search/TimeManager.hpp"
+#include "search/parallel_search_type.hpp"
+#include "search/search_algorithm.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+// Every thread runs its own iterative deepening with its own history and killers, and they share the transposition table.
+// Thread 0 is the main thread, the search ends when it has finished. How the threads split the work depends on the
+// parallel search type.
+class ThreadPool
+{
+public:
+	ThreadPool(EVALUATION_TYPE evaluation_type);
+
+	// Keeps the searches of the remaining threads, new threads start with empty tables
+	void set_thread_count(size_t thread_count);
+	size_t get_thread_count() const;
+
+	void set_parallel_search_type(ParallelSearchType parallel_search_type);
+
+	// MCTS runs on as many threads as alpha-beta would
+	void set_search_algorithm(SearchAlgorithm search_algorithm);
+
+	// Only the main thread searches and reports several lines, the helpers just fill the table for them
+	void set_multi_pv(unsigned int line_count);
+
+	// Forget everything learned in previous searches, for a new game
+	void clear();
+
+	// Starts the clock for the search. Call before the search starts, from the thread handling go.
+	void start_clock(const SearchLimits& limits, Color player);
+	void ponderhit();
+
+	// Runs the search on all threads and returns the best move agreed on by the threads.
+	// With a mate limit the proof-number search tries to prove the mate first, on the calling thread.
+	// With MCTS selected the threads search one shared tree instead.
+	// Call clear_stop first, a stop arriving before the search has started is kept.
+	Move search_for_best_move(const Position& position, std::span<const uint64_t> key_history, const MoveList& legal_moves, const SearchLimits& limits);
+
+	// Safe to call from any thread. The search returns the result of the last completed iterations.
+	void stop();
+	void clear_stop();
+
+	// Summed over all threads, for the last search
+	uint64_t get_nodes() const;
+
+private:
+	// Lazy SMP: each thread votes for its best move, weighted by its completed depth and score.
+	// ABDADA: the threads search the same tree, so the main thread has the answer.
+	// MultiPV: only the main thread searched and reported the lines, so its move goes with them.
+	size_t select_best_thread() const;
+
+	EVALUATION_TYPE m_evaluation_type;
+	ParallelSearchType m_parallel_search_type = ParallelSearchType::LazySMP;
+	SearchAlgorithm m_search_algorithm = SearchAlgorithm::AlphaBeta;
+	unsigned int m_multi_pv = 1;
+	std::vector<std::unique_ptr<Search>> m_searches;
+	std::atomic<bool> m_stop = false;
+	std::atomic<uint64_t> m_nodes = 0;
+	TimeManager m_time_manager;  // Used by the main thread
+	ProofNumberSearch m_proof_number_search;
+	MonteCarloTreeSearch m_monte_carlo_tree_search;
+};
+
+#endif  // SEARCH_THREADPOOL_HPP
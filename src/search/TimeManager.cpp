@@ -0,0 +1,113 @@
+#include "TimeManager.hpp"
+
+#include <algorithm>
+
+// Subtracted for every move we plan for, to cover GUI and communication lag
+constexpr int64_t move_overhead_ms = 20;
+
+// Without movestogo the remaining time is spread as if this many moves were left
+constexpr int64_t default_moves_to_go = 40;
+constexpr int64_t max_moves_to_go = 50;
+
+// The hard limit is this many soft limits, but never more than this part of the remaining time
+constexpr int64_t hard_limit_soft_multiple = 5;
+constexpr double hard_limit_max_fraction = 0.8;
+
+// Soft limit scaling. A best move that keeps changing or a dropping score gets more time, a settled best move less.
+constexpr double best_move_changes_decay = 0.5;
+constexpr double stable_best_move_scale = 0.6;
+constexpr double unstable_best_move_scale = 1.0;  // Per decayed best move change
+constexpr unsigned int stable_best_move_iterations = 4;
+constexpr int score_drop_max = 100;
+constexpr double score_drop_scale = 0.5;  // Extra soft time at the maximum score drop
+
+void TimeManager::start(const SearchLimits& limits, Color player)
+{
+	m_start = Clock::now();
+	m_pondering = limits.ponder;
+	m_iterations = 0;
+	m_previous_best_move = Move();
+	m_previous_score = 0;
+	m_best_move_stability = 0;
+	m_best_move_changes = 0.0;
+
+	m_time_limited = !limits.infinite && limits.has_time_limit();
+	m_fixed_time = limits.move_time.has_value();
+
+	if (!m_time_limited)
+	{
+		return;
+	}
+
+	if (limits.move_time.has_value())
+	{
+		m_hard_limit_ms = std::max<int64_t>(1, *limits.move_time - move_overhead_ms);
+		m_soft_limit_ms = m_hard_limit_ms;
+		return;
+	}
+
+	const std::optional<int64_t>& clock = (player == Color::White) ? limits.white_time : limits.black_time;
+	const int64_t time_left = clock.value_or(0);
+	const int64_t increment = (player == Color::White) ? limits.white_increment : limits.black_increment;
+	const int64_t moves_to_go = (limits.moves_to_go == 0) ? default_moves_to_go : std::min<int64_t>(limits.moves_to_go, max_moves_to_go);
+
+	const int64_t available = std::max<int64_t>(1, time_left + increment * (moves_to_go - 1) - move_overhead_ms * moves_to_go);
+
+	m_hard_limit_ms = std::max<int64_t>(1, std::min<int64_t>(static_cast<int64_t>(time_left * hard_limit_max_fraction) - move_overhead_ms, available / moves_to_go * hard_limit_soft_multiple));
+	m_soft_limit_ms = std::clamp<int64_t>(available / moves_to_go, 1, m_hard_limit_ms);
+}
+
+void TimeManager::ponderhit()
+{
+	m_pondering = false;
+}
+
+int64_t TimeManager::get_elapsed_ms() const
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - m_start).count();
+}
+
+bool TimeManager::hard_limit_reached() const
+{
+	return m_time_limited && !m_pondering && get_elapsed_ms() >= m_hard_limit_ms;
+}
+
+bool TimeManager::hard_limit_fraction_reached(double fraction) const
+{
+	return m_time_limited && !m_pondering && get_elapsed_ms() >= static_cast<int64_t>(m_hard_limit_ms * fraction);
+}
+
+bool TimeManager::soft_limit_reached() const
+{
+	return m_time_limited && !m_pondering && get_elapsed_ms() >= m_soft_limit_ms;
+}
+
+bool TimeManager::should_stop_after_iteration(const Move& best_move, int score)
+{
+	const bool best_move_changed = (m_iterations > 0 && best_move != m_previous_best_move);
+	const int score_drop = (m_iterations > 0) ? std::clamp(m_previous_score - score, 0, score_drop_max) : 0;
+
+	m_best_move_changes = m_best_move_changes * best_move_changes_decay + (best_move_changed ? 1.0 : 0.0);
+	m_best_move_stability = best_move_changed ? 0 : m_best_move_stability + 1;
+	m_previous_best_move = best_move;
+	m_previous_score = score;
+	m_iterations++;
+
+	if (!m_time_limited || m_fixed_time || m_pondering)
+	{
+		return false;
+	}
+
+	double scale = 1.0 + m_best_move_changes * unstable_best_move_scale;
+	scale *= 1.0 + score_drop_scale * score_drop / score_drop_max;
+
+	if (m_best_move_stability >= stable_best_move_iterations)
+	{
+		scale *= stable_best_move_scale;
+	}
+
+	const int64_t soft_limit = std::min(m_hard_limit_ms, static_cast<int64_t>(m_soft_limit_ms * scale));
+
+	// The next iteration takes several times longer than this one, do not start one that cannot finish
+	return get_elapsed_ms() >= soft_limit / 2;
+}
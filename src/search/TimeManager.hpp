@@ -0,0 +1,59 @@
+#ifndef SEARCH_TIMEMANAGER_HPP
+#define SEARCH_TIMEMANAGER_HPP
+
+#include "search/SearchLimits.hpp"
+#include "types/Color.hpp"
+#include "types/Move.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Splits the clock into a soft limit, checked between iterations and scaled by how settled the search is,
+// and a hard limit, checked every few nodes, which the search never runs past.
+class TimeManager
+{
+public:
+	TimeManager() = default;
+
+	// Starts the clock. Called before the search threads start.
+	void start(const SearchLimits& limits, Color player);
+
+	// The clock does not stop the search while pondering. The time spent pondering still counts afterwards.
+	void ponderhit();
+
+	// Milliseconds since start, from a monotonic clock
+	int64_t get_elapsed_ms() const;
+
+	// Main thread only, every few nodes
+	bool hard_limit_reached() const;
+
+	// For a search that has to leave the rest of the time to another one
+	bool hard_limit_fraction_reached(double fraction) const;
+
+	// For a search without iterations, which can stop at the planned time for the move
+	bool soft_limit_reached() const;
+
+	// Main thread only, after each completed iteration
+	bool should_stop_after_iteration(const Move& best_move, int score);
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	Clock::time_point m_start;
+	bool m_time_limited = false;
+	bool m_fixed_time = false;  // movetime, search until the hard limit
+	std::atomic<bool> m_pondering = false;
+
+	int64_t m_soft_limit_ms = 0;
+	int64_t m_hard_limit_ms = 0;
+
+	// State of previous iterations
+	unsigned int m_iterations = 0;
+	Move m_previous_best_move;
+	int m_previous_score = 0;
+	unsigned int m_best_move_stability = 0;  // Iterations in a row with the same best move
+	double m_best_move_changes = 0.0;        // Decaying count of best move changes
+};
+
+#endif  // SEARCH_TIMEMANAGER_HPP
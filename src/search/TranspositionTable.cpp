@@ -0,0 +1,164 @@
+#include "TranspositionTable.hpp"
+
+#include <algorithm>
+
+constexpr size_t default_size_megabytes = 1;
+
+TranspositionTable::TranspositionTable()
+{
+	resize(default_size_megabytes);
+}
+
+void TranspositionTable::resize(size_t megabytes)
+{
+	// Round down to a power of two so the index is a mask
+	size_t slot_count = 1;
+
+	while (slot_count * 2 * sizeof(Slot) <= megabytes * 1024 * 1024)
+	{
+		slot_count *= 2;
+	}
+
+	m_slots = std::make_unique<Slot[]>(slot_count);
+	m_slot_count = slot_count;
+
+	if (m_busy)
+	{
+		m_busy = std::make_unique<std::atomic<uint8_t>[]>(slot_count);
+	}
+}
+
+void TranspositionTable::set_busy_counters(bool enabled)
+{
+	if (enabled == static_cast<bool>(m_busy))
+	{
+		return;
+	}
+
+	m_busy = enabled ? std::make_unique<std::atomic<uint8_t>[]>(m_slot_count) : nullptr;
+}
+
+void TranspositionTable::clear()
+{
+	for (size_t i = 0; i < m_slot_count; i++)
+	{
+		m_slots[i].checked_key.store(0, std::memory_order_relaxed);
+		m_slots[i].data.store(0, std::memory_order_relaxed);
+	}
+
+	if (m_busy)
+	{
+		for (size_t i = 0; i < m_slot_count; i++)
+		{
+			m_busy[i].store(0, std::memory_order_relaxed);
+		}
+	}
+
+	m_generation = 0;
+}
+
+void TranspositionTable::new_search()
+{
+	m_generation++;
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry& entry) const
+{
+	const Slot& slot = m_slots[get_index(key)];
+
+	const uint64_t data = slot.data.load(std::memory_order_relaxed);
+	const uint64_t checked_key = slot.checked_key.load(std::memory_order_relaxed);
+
+	if ((checked_key ^ data) != key)
+	{
+		return false;
+	}
+
+	entry = unpack(key, data);
+	return entry.bound != Bound::None;
+}
+
+void TranspositionTable::store(uint64_t key, Move move, int16_t score, uint8_t depth, Bound bound)
+{
+	Slot& slot = m_slots[get_index(key)];
+
+	const uint64_t stored_data = slot.data.load(std::memory_order_relaxed);
+	const uint64_t stored_key = slot.checked_key.load(std::memory_order_relaxed) ^ stored_data;
+	const TTEntry stored = unpack(stored_key, stored_data);
+
+	// Prefer keeping deeper entries from the current search
+	if (stored.key == key || stored.generation != m_generation || depth >= stored.depth || bound == Bound::Exact)
+	{
+		// Keep the old move if we do not have a new one for the same position
+		if (stored.key == key && move == Move())
+		{
+			move = stored.move;
+		}
+
+		const uint64_t data = pack({key, move, score, depth, bound, m_generation});
+
+		slot.checked_key.store(key ^ data, std::memory_order_relaxed);
+		slot.data.store(data, std::memory_order_relaxed);
+	}
+}
+
+unsigned int TranspositionTable::get_hashfull() const
+{
+	const size_t sample_size = std::min<size_t>(1000, m_slot_count);
+	size_t used = 0;
+
+	for (size_t i = 0; i < sample_size; i++)
+	{
+		const uint64_t data = m_slots[i].data.load(std::memory_order_relaxed);
+		const TTEntry entry = unpack(0, data);
+
+		if (entry.bound != Bound::None && entry.generation == m_generation)
+		{
+			used++;
+		}
+	}
+
+	return static_cast<unsigned int>(used * 1000 / sample_size);
+}
+
+void TranspositionTable::set_busy(uint64_t key)
+{
+	m_busy[get_index(key)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void TranspositionTable::clear_busy(uint64_t key)
+{
+	m_busy[get_index(key)].fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool TranspositionTable::is_busy(uint64_t key) const
+{
+	return m_busy[get_index(key)].load(std::memory_order_relaxed) != 0;
+}
+
+uint64_t TranspositionTable::pack(const TTEntry& entry)
+{
+	const uint64_t move = entry.move.get_to_square().get_data() | (entry.move.get_from_square().get_data() << 6) | (static_cast<uint64_t>(entry.move.get_type()) << 12);
+
+	return move | (static_cast<uint64_t>(static_cast<uint16_t>(entry.score)) << 16) | (static_cast<uint64_t>(entry.depth) << 32) | (static_cast<uint64_t>(entry.bound) << 40) |
+		   (static_cast<uint64_t>(entry.generation) << 48);
+}
+
+TTEntry TranspositionTable::unpack(uint64_t key, uint64_t data)
+{
+	TTEntry entry;
+
+	entry.key = key;
+	entry.move = Move(Square(static_cast<uint8_t>((data >> 6) & 0x3F)), Square(static_cast<uint8_t>(data & 0x3F)), static_cast<MoveType>((data >> 12) & 0xF));
+	entry.score = static_cast<int16_t>(static_cast<uint16_t>(data >> 16));
+	entry.depth = static_cast<uint8_t>(data >> 32);
+	entry.bound = static_cast<Bound>((data >> 40) & 0xFF);
+	entry.generation = static_cast<uint8_t>(data >> 48);
+
+	return entry;
+}
+
+size_t TranspositionTable::get_index(uint64_t key) const
+{
+	return key & (m_slot_count - 1);
+}
@@ -0,0 +1,80 @@
+#ifndef SEARCH_TRANSPOSITIONTABLE_HPP
+#define SEARCH_TRANSPOSITIONTABLE_HPP
+
+#include "types/Move.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+enum class Bound : uint8_t
+{
+	None = 0,
+	Upper = 1,  // Failed low, score is at most this
+	Lower = 2,  // Failed high, score is at least this
+	Exact = 3
+};
+
+struct TTEntry
+{
+	uint64_t key = 0;
+	Move move;
+	int16_t score = 0;
+	uint8_t depth = 0;
+	Bound bound = Bound::None;
+	uint8_t generation = 0;
+};
+
+// Shared by all search threads without locks. Each slot is two atomic words, the key is stored xor'ed with the data,
+// so a slot torn by two threads writing at once fails the key check instead of returning another position's data.
+class TranspositionTable
+{
+public:
+	TranspositionTable();
+
+	// The size covers the slots. The ABDADA busy counters, one byte per slot, come on top while they are enabled.
+	void resize(size_t megabytes);
+	void clear();
+
+	// Only ABDADA needs the busy counters, so they are allocated while it is selected. Not thread safe.
+	void set_busy_counters(bool enabled);
+
+	// Called at the start of every search, so entries from older searches are replaced first. Not thread safe.
+	void new_search();
+
+	// Copies the entry into 'entry' and returns true if the position is in the table
+	bool probe(uint64_t key, TTEntry& entry) const;
+
+	void store(uint64_t key, Move move, int16_t score, uint8_t depth, Bound bound);
+
+	// Permille of a sample of slots filled in the current search, for UCI hashfull
+	unsigned int get_hashfull() const;
+
+	// ABDADA: count of threads currently searching the position. Positions sharing a slot share the count.
+	// Only valid while the busy counters are enabled.
+	void set_busy(uint64_t key);
+	void clear_busy(uint64_t key);
+	bool is_busy(uint64_t key) const;
+
+private:
+	struct Slot
+	{
+		std::atomic<uint64_t> checked_key;  // key ^ data
+		std::atomic<uint64_t> data;
+	};
+
+	static uint64_t pack(const TTEntry& entry);
+	static TTEntry unpack(uint64_t key, uint64_t data);
+
+	size_t get_index(uint64_t key) const;
+
+	std::unique_ptr<Slot[]> m_slots;
+	std::unique_ptr<std::atomic<uint8_t>[]> m_busy;  // nullptr unless enabled
+	size_t m_slot_count = 0;
+	uint8_t m_generation = 0;
+};
+
+inline TranspositionTable transposition_table;
+
+#endif  // SEARCH_TRANSPOSITIONTABLE_HPP
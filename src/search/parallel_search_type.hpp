@@ -0,0 +1,10 @@
+#ifndef SEARCH_PARALLEL_SEARCH_TYPE_HPP
+#define SEARCH_PARALLEL_SEARCH_TYPE_HPP
+
+enum class ParallelSearchType
+{
+	LazySMP,  // Threads search independently, staggered over depths, sharing only the transposition table
+	ABDADA    // Threads search the same depth and put off moves another thread is busy with
+};
+
+#endif  // SEARCH_PARALLEL_SEARCH_TYPE_HPP
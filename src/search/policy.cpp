@@ -0,0 +1,82 @@
+#include "policy.hpp"
+
+#include "position/PositionAnalysis.hpp"
+#include "search/MovePicker.hpp"
+#include "search/see.hpp"
+#include "types/conversions.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Logits, softmaxed into priors. A quiet move is 0.
+constexpr float winning_capture_logit = 2.0f;
+constexpr float losing_capture_logit = -1.0f;
+constexpr float mvv_lva_logit_scale = 1.0f / 16.0f;
+constexpr float queen_promotion_logit = 2.5f;
+constexpr float underpromotion_logit = -3.0f;
+constexpr float check_logit = 1.0f;
+constexpr float castling_logit = 0.5f;
+
+void heuristic_policy(const Position& position, std::span<const Move> moves, std::span<float> priors)
+{
+	if (moves.empty())
+	{
+		return;
+	}
+
+	float max_logit = std::numeric_limits<float>::lowest();
+
+	for (size_t i = 0; i < moves.size(); i++)
+	{
+		const Move& move = moves[i];
+		const MoveType type = move.get_type();
+		const Piece promotion = convert_promo_to_piece(type);
+
+		float logit = 0.0f;
+
+		if (position.is_capture(move))
+		{
+			logit += see(position, move, 0) ? winning_capture_logit : losing_capture_logit;
+			logit += MovePicker::mvv_lva(position, move) * mvv_lva_logit_scale;
+		}
+
+		if (promotion == Piece::Queen)
+		{
+			logit += queen_promotion_logit;
+		}
+		else if (promotion != Piece::Empty)
+		{
+			logit += underpromotion_logit;
+		}
+
+		if (type == MoveType::KingCastle || type == MoveType::QueenCastle)
+		{
+			logit += castling_logit;
+		}
+
+		Position child = position;
+		child.make_move(move);
+
+		if (PositionAnalysis(child).player_in_check())
+		{
+			logit += check_logit;
+		}
+
+		priors[i] = logit;
+		max_logit = std::max(max_logit, logit);
+	}
+
+	float sum = 0.0f;
+
+	for (size_t i = 0; i < moves.size(); i++)
+	{
+		priors[i] = std::exp(priors[i] - max_logit);
+		sum += priors[i];
+	}
+
+	for (size_t i = 0; i < moves.size(); i++)
+	{
+		priors[i] /= sum;
+	}
+}
@@ -0,0 +1,16 @@
+#ifndef SEARCH_POLICY_HPP
+#define SEARCH_POLICY_HPP
+
+#include "position/Position.hpp"
+#include "types/Move.hpp"
+
+#include <span>
+
+// A policy gives every legal move of a position a prior probability, the chance it is the best move.
+// The priors written to priors sum to one.
+using PolicyFunction = void (*)(const Position& position, std::span<const Move> moves, std::span<float> priors);
+
+// Move ordering knowledge as a policy: winning captures, promotions and checks first, then the other moves
+void heuristic_policy(const Position& position, std::span<const Move> moves, std::span<float> priors);
+
+#endif  // SEARCH_POLICY_HPP
@@ -0,0 +1,62 @@
+#ifndef SEARCH_SCORE_HPP
+#define SEARCH_SCORE_HPP
+
+#include "types/Piece.hpp"
+
+#include <array>
+#include <cstdint>
+
+// All search scores are relative to the player to move, in centipawns. They fit in an int16_t for the transposition table.
+
+constexpr int infinite_score = 32001;
+
+// Being mated at ply n scores -(mate_score - n), so shorter mates are preferred.
+constexpr int mate_score = 32000;
+
+constexpr unsigned int max_search_ply = 128;
+
+// Anything beyond this is a forced mate
+constexpr int mate_bound = mate_score - static_cast<int>(max_search_ply);
+
+constexpr int draw_score = 0;
+
+// Material values used by search heuristics (pruning margins, exchanges), independent of the evaluation function. Indexed by Piece.
+constexpr std::array<int, types_of_pieces + 1> piece_values = {100, 320, 330, 500, 900, 20000, 0};
+
+constexpr int get_piece_value(Piece piece)
+{
+	return piece_values[static_cast<uint8_t>(piece)];
+}
+
+// Mate scores are stored relative to the node in the transposition table, and relative to the root while searching
+constexpr int16_t score_to_tt(int score, unsigned int ply)
+{
+	if (score >= mate_bound)
+	{
+		score += static_cast<int>(ply);
+	}
+	else if (score <= -mate_bound)
+	{
+		score -= static_cast<int>(ply);
+	}
+
+	return static_cast<int16_t>(score);
+}
+
+constexpr int score_from_tt(int16_t tt_score, unsigned int ply)
+{
+	int score = tt_score;
+
+	if (score >= mate_bound)
+	{
+		score -= static_cast<int>(ply);
+	}
+	else if (score <= -mate_bound)
+	{
+		score += static_cast<int>(ply);
+	}
+
+	return score;
+}
+
+#endif  // SEARCH_SCORE_HPP
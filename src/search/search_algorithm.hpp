@@ -0,0 +1,10 @@
+#ifndef SEARCH_SEARCH_ALGORITHM_HPP
+#define SEARCH_SEARCH_ALGORITHM_HPP
+
+enum class SearchAlgorithm
+{
+	AlphaBeta,  // Iterative deepening principal variation search
+	MCTS        // Monte Carlo tree search with PUCT selection
+};
+
+#endif  // SEARCH_SEARCH_ALGORITHM_HPP
@@ -0,0 +1,99 @@
+#include "see.hpp"
+
+#include "movegen/movegen.hpp"
+#include "search/score.hpp"
+
+bool see(const Position& position, const Move& move, int threshold)
+{
+	const MoveType type = move.get_type();
+
+	// Castling, en passant and promotions are not exchanges on a single square
+	if (type == MoveType::KingCastle || type == MoveType::QueenCastle || type == MoveType::EnPassant || (type >= MoveType::KnightPromo && type <= MoveType::QueenPromo))
+	{
+		return threshold <= 0;
+	}
+
+	const Square from_square = move.get_from_square();
+	const Square to_square = move.get_to_square();
+
+	// What we gain if the piece is not recaptured
+	int swap = get_piece_value(position.get_piece(to_square)) - threshold;
+	if (swap < 0)
+	{
+		return false;
+	}
+
+	// What we gain if the piece is recaptured for free
+	swap = get_piece_value(position.get_piece(from_square)) - swap;
+	if (swap <= 0)
+	{
+		return true;
+	}
+
+	Bitboard occupancy = position.get_bitboard(Color::White) | position.get_bitboard(Color::Black);
+	occupancy.clear_by_square(from_square);
+	occupancy.clear_by_square(to_square);
+
+	const Bitboard queens = position.get_bitboard(Piece::Queen);
+	const Bitboard diagonal_sliders = position.get_bitboard(Piece::Bishop) | queens;
+	const Bitboard orthogonal_sliders = position.get_bitboard(Piece::Rook) | queens;
+
+	Bitboard attackers = attackers_to(position, to_square, occupancy);
+
+	Color player = position.get_player();
+	bool result = true;  // True if the player who made the last capture wins the exchange
+
+	while (true)
+	{
+		player = get_other_color(player);
+		attackers = attackers & occupancy;
+
+		const Bitboard player_attackers = attackers & position.get_bitboard(player);
+		if (player_attackers.empty())
+		{
+			break;
+		}
+
+		result = !result;
+
+		// Least valuable attacker
+		Piece piece = Piece::Pawn;
+		Bitboard least_valuable;
+		for (; piece != Piece::King; piece = static_cast<Piece>(static_cast<uint8_t>(piece) + 1))
+		{
+			least_valuable = player_attackers & position.get_bitboard(piece);
+			if (!least_valuable.empty())
+			{
+				break;
+			}
+		}
+
+		// Capturing with the king is only legal if the opponent has no attackers left
+		if (piece == Piece::King)
+		{
+			const Bitboard opponent_attackers = attackers & position.get_bitboard(get_other_color(player));
+			return opponent_attackers.empty() ? result : !result;
+		}
+
+		// The capturing piece is now exposed. If even that is not enough to turn the exchange, we can stop.
+		swap = get_piece_value(piece) - swap;
+		if (swap < static_cast<int>(result))
+		{
+			break;
+		}
+
+		occupancy.clear_by_square(Square(least_valuable.scan_forward()));
+
+		// Reveal x-ray attackers behind the piece that just captured
+		if (piece == Piece::Pawn || piece == Piece::Bishop || piece == Piece::Queen)
+		{
+			attackers = attackers | (generate_diagonal_attacks(to_square, occupancy) & diagonal_sliders);
+		}
+		if (piece == Piece::Rook || piece == Piece::Queen)
+		{
+			attackers = attackers | (generate_orthogonal_attacks(to_square, occupancy) & orthogonal_sliders);
+		}
+	}
+
+	return result;
+}
@@ -0,0 +1,11 @@
+#ifndef SEARCH_SEE_HPP
+#define SEARCH_SEE_HPP
+
+#include "position/Position.hpp"
+#include "types/Move.hpp"
+
+// Static exchange evaluation. Returns true if the exchange sequence started by move on its to square gains at least threshold,
+// when both sides keep recapturing with their least valuable attacker. Pins are ignored.
+bool see(const Position& position, const Move& move, int threshold);
+
+#endif  // SEARCH_SEE_HPP
@@ -3,6 +3,7 @@
 
 #include "types/Square.hpp"
 
+#include <bit>
 #include <cstdint>
 
 class Bitboard
@@ -26,8 +27,7 @@ public:
 
 	constexpr uint8_t read_bitcount() const
 	{
-		// Implement with fancy inline ASM thingy
-		return 0;
+		return static_cast<uint8_t>(std::popcount(m_board));
 	}
 
 	constexpr void set_by_square(Square square)
@@ -63,21 +63,26 @@ public:
 		return m_board == 0;
 	}
 
-	constexpr Bitboard operator|(const Bitboard& rhs)
+	constexpr Bitboard operator|(const Bitboard& rhs) const
 	{
 		return Bitboard(m_board | rhs.get_data());
 	}
 
-	constexpr Bitboard operator&(const Bitboard& rhs)
+	constexpr Bitboard operator&(const Bitboard& rhs) const
 	{
 		return Bitboard(m_board & rhs.get_data());
 	}
 
-	constexpr Bitboard operator~()
+	constexpr Bitboard operator~() const
 	{
 		return Bitboard(~m_board);
 	}
 
+	constexpr Bitboard operator^(const Bitboard& rhs) const
+	{
+		return Bitboard(m_board ^ rhs.get_data());
+	}
+
 private:
 	uint64_t m_board = 0;
 };
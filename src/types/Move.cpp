@@ -2,7 +2,7 @@
 
 #include "types/conversions.hpp"
 
-Move::Move(const std::string& move_string)
+Move::Move(std::string_view move_string)
 {
 	if (move_string == "0000")
 	{
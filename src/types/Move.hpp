@@ -7,6 +7,7 @@
 
 #include <cstdint>
 #include <string>
+#include <string_view>
 
 enum class MoveType : uint8_t
 {
@@ -33,7 +34,7 @@ class Move
 public:
 	Move() = default;
 
-	Move(const std::string& move_string);  // Construct the move on an empty board from a move string. "e7e8q", for instance
+	Move(std::string_view move_string);  // Construct the move on an empty board from a move string. "e7e8q", for instance
 
 	Move(Square from, Square to, MoveType type = MoveType::Quiet)
 	{
@@ -72,6 +73,8 @@ public:
 		return static_cast<MoveType>(get_bits<uint16_t, 12, 4>(m_encoded_move));
 	}
 
+	bool operator==(const Move& rhs) const = default;
+
 	std::string get_string() const
 	{
 		std::string str;
@@ -1,7 +1,10 @@
 #ifndef UTIL_STRING_UTILS_HPP
 #define UTIL_STRING_UTILS_HPP
 
+#include <charconv>
+#include <string>
 #include <string_view>
+#include <vector>
 
 #include <cctype>
 
@@ -23,4 +26,57 @@ inline bool string_compare(std::string_view a, std::string_view b)
 	return true;
 }
 
+// Splits the line at whitespace. The tokens point into the line, and tokens keeps its capacity between calls.
+inline void tokenize(std::string_view line, std::vector<std::string_view>& tokens)
+{
+	constexpr std::string_view whitespace = " \t\r\n";
+
+	tokens.clear();
+
+	size_t start = line.find_first_not_of(whitespace);
+
+	while (start != std::string_view::npos)
+	{
+		const size_t end = line.find_first_of(whitespace, start);
+
+		tokens.push_back(line.substr(start, end - start));
+		start = line.find_first_not_of(whitespace, end);
+	}
+}
+
+// The text from the first token to the end of the last, as it was in the line the tokens point into
+inline std::string_view join_tokens(const std::string_view* first, const std::string_view* last)
+{
+	if (first == last)
+	{
+		return {};
+	}
+
+	return std::string_view(first->data(), static_cast<size_t>((last - 1)->data() + (last - 1)->size() - first->data()));
+}
+
+// 0 if the token is not a number
+template <typename T>
+T parse_number(std::string_view token)
+{
+	T value = 0;
+
+	if (std::from_chars(token.data(), token.data() + token.size(), value).ec != std::errc())
+	{
+		return 0;
+	}
+
+	return value;
+}
+
+// std::to_string without the temporary string
+template <typename T>
+void append_number(std::string& string, T value)
+{
+	char buffer[24];
+
+	const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+	string.append(buffer, result.ptr);
+}
+
 #endif  // UTIL_STRING_UTILS_HPP